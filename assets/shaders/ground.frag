@@ -1,9 +1,11 @@
-#version 460 core
+#version 450 core
 out vec4 FragColor;
 
 in vec3 FragPos;
 in vec2 TexCoords;
 in vec3 Normal; 
+in float ViewDepth;
+flat in int ViewIndex;
 
 uniform sampler2D albedoMap;
 uniform sampler2D normalMap;
@@ -11,73 +13,116 @@ uniform sampler2D roughnessMap;
 uniform sampler2D aoMap;
 uniform sampler2D dispMap; 
 
-uniform vec3 viewPos;
+// 多视图：所有视图的相机矩阵在一个 UBO 里 (见 MultiView.h)
+#define MAX_VIEWS 4
+struct ViewData {
+    mat4 view;
+    mat4 projection;
+    vec4 position;
+    vec4 viewport;   // x, y, width, height
+};
+layout(std140, binding = 0) uniform CameraViews { ViewData views[MAX_VIEWS]; };
 uniform float wetness; 
 uniform float time; 
 
-// --- []  2D α ---
+// --- 分簇光照数据 (由 LightGrid 每帧上传) ---
+struct Light {
+    vec4 positionRange;   // xyz: 位置, w: 地面光斑半径
+    vec4 color;           // rgb: 颜色 * 强度
+};
+layout(std430, binding = 0) readonly buffer LightBuffer { Light lights[]; };
+layout(std430, binding = 1) readonly buffer ClusterBuffer { uvec2 clusters[]; };   // x: offset, y: count
+layout(std430, binding = 2) readonly buffer LightIndexBuffer { uint lightIndices[]; };
+layout(std430, binding = 3) readonly buffer GridBuffer {
+    uvec4 gridDims;       // xyz: 簇网格尺寸, w: 视图数
+    vec4 gridParams;      // x: zScale, y: zBias
+};
+
+// --- [新增] 高质量的 2D 伪随机函数 ---
 vec2 hash22(vec2 p) {
     vec3 p3 = fract(vec3(p.xyx) * vec3(.1031, .1030, .0973));
     p3 += dot(p3, p3.yzx  + 33.33);
     return fract((p3.xx + p3.yz) * p3.zy);
 }
 
-// --- [Ľ] β ---
+// --- [改进] 单层雨滴波纹生成器 ---
 vec2 rippleLayer(vec2 uv, float t, float scale) {
     vec2 p = uv * scale;
-    vec2 i = floor(p); //  ID
+    vec2 i = floor(p); // 网格 ID
     
-    // ˮļƫƣ
+    // 给水滴中心加上随机偏移，打破死板的网格感
     vec2 centerOffset = (hash22(i) - 0.5) * 0.4; 
-    vec2 f = fract(p) - 0.5 - centerOffset; // ڵľֲ
+    vec2 f = fract(p) - 0.5 - centerOffset; // 网格内的局部坐标
     
-    // ʱƫ
+    // 随机的时间偏移
     float randTime = hash22(i + 1.414).x;
     float dropTime = fract(t + randTime);
     float dist = length(f);
     
-    // ƻ͵
+    // 波纹环和淡出计算
     float ring = max(0.0, 1.0 - abs(dist - dropTime) * 12.0);
     float fade = (1.0 - dropTime) * smoothstep(0.5, 0.1, dist);
     
-    //  XY ƫ
+    // 返回 XY 偏移量
     return f * ring * fade * 0.4;
 }
 
-// --- [Ľ] 㲨ƻ ---
+// --- [改进] 多层波纹混合 ---
 vec3 getRainRippleNormal(vec2 uv, float t) {
-    // һ㲨ƣϴԿ
+    // 第一层波纹：较大，流速稍快
     vec2 offset1 = rippleLayer(uv, t * 1.5, 15.0);
-    // ڶ㲨ƣС UV ƫƣٲͬ
+    // 第二层波纹：较小，带有 UV 偏移，流速不同
     vec2 offset2 = rippleLayer(uv + vec2(0.23, 0.47), t * 1.2 + 0.5, 22.0);
     
-    // ӣɸгʧ
+    // 两层叠加，规律感彻底消失
     vec2 finalOffset = offset1 + offset2;
     return normalize(vec3(finalOffset.x, finalOffset.y, 1.0));
 }
 
-void main()
+uint clusterIndex()
 {
-    // 1. 
-    vec3 albedo = texture(albedoMap, TexCoords).rgb;
-    float roughness = texture(roughnessMap, TexCoords).r;
-    float ao = texture(aoMap, TexCoords).r;
-    float disp = texture(dispMap, TexCoords).r; 
+    // tile 相对本视图的视口计算，每个视图有自己的一套簇
+    vec4 viewport = views[ViewIndex].viewport;
+    uvec2 tile = uvec2((gl_FragCoord.xy - viewport.xy) / viewport.zw * vec2(gridDims.xy));
+    int slice = int(floor(log(ViewDepth) * gridParams.x - gridParams.y));
+    uvec3 c = min(uvec3(tile, uint(max(slice, 0))), gridDims.xyz - 1u);
+    uint clustersPerView = gridDims.x * gridDims.y * gridDims.z;
+    return uint(ViewIndex) * clustersPerView + (c.z * gridDims.y + c.y) * gridDims.x + c.x;
+}
 
-    vec3 normalMapValue = texture(normalMap, TexCoords).rgb;
+void main()
+{
+    // 0. 定位所在的簇。空簇 (没有任何路灯照到) 直接输出黑色，连纹理都不采
+    //    导数必须在分支之前求，分支之后统一用 textureGrad
+    vec2 dx = dFdx(TexCoords);
+    vec2 dy = dFdy(TexCoords);
+    uvec2 cluster = clusters[clusterIndex()];
+    if (cluster.y == 0u)
+    {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // 1. 基础采样
+    vec3 albedo = textureGrad(albedoMap, TexCoords, dx, dy).rgb;
+    float roughness = textureGrad(roughnessMap, TexCoords, dx, dy).r;
+    float ao = textureGrad(aoMap, TexCoords, dx, dy).r;
+    float disp = textureGrad(dispMap, TexCoords, dx, dy).r; 
+
+    vec3 normalMapValue = textureGrad(normalMap, TexCoords, dx, dy).rgb;
     normalMapValue = normalize(normalMapValue * 2.0 - 1.0);
 
-    // --- 2. ߼ (ʪˮ) ---
+    // --- 2. 遮罩逻辑 (区分湿润区与深水区) ---
     float waterDepth = wetness - disp;
     
-    // puddleMaskڲɫƽ (0.0  0.1)
+    // puddleMask：用于材质颜色的平滑过渡 (0.0 到 0.1)
     float puddleMask = smoothstep(0.0, 0.1, waterDepth);
     
-    // rippleMask [޸]ֻˮ 0.05 ġˮв
-    // ⲨʯͷԵɡģ
+    // rippleMask [核心修复]：只在水深大于 0.05 的“深水区”才允许有波纹
+    // 避免波纹爬上石头边缘造成“穿模”错觉
     float rippleMask = smoothstep(0.05, 0.1, waterDepth);
 
-    // 3. PBR Ի
+    // 3. PBR 属性混合
     vec3 dampAlbedo = albedo * 0.6;      
     vec3 puddleAlbedo = albedo * 0.2;    
     vec3 finalAlbedo = mix(dampAlbedo, puddleAlbedo, puddleMask);
@@ -85,70 +130,71 @@ void main()
     float dampRoughness = roughness * 0.8;
     float finalRoughness = mix(dampRoughness, 0.02, puddleMask);
 
-    // --- 4. ߻ (ƴģ) ---
+    // --- 4. 法线混合 (解决波纹穿模) ---
     vec3 rippleNormal = getRainRippleNormal(TexCoords, time);
     
-    // ˮĴƽ (0,0,1)
+    // 水面的纯平法线 (0,0,1)
     vec3 flatWaterNormal = vec3(0.0, 0.0, 1.0);
-    // ˮ淨 = ƽ +  ( rippleMask ϸ)
+    // 真正的水面法线 = 平面 + 波纹 (受 rippleMask 严格限制)
     vec3 finalWaterNormal = normalize(mix(flatWaterNormal, rippleNormal, rippleMask));
     
-    // շ = ʯͷ͹ˮ
+    // 最终法线 = 混合石头凹凸与真正的水面
     vec3 finalNormalMapValue = normalize(mix(normalMapValue, finalWaterNormal, puddleMask));
 
-// 5. TBN ת
+// 5. TBN 转换
     vec3 T = vec3(1.0, 0.0, 0.0);
     vec3 B = vec3(0.0, 0.0, 1.0);
     vec3 N_geom = vec3(0.0, 1.0, 0.0);
     mat3 TBN = mat3(T, B, N_geom);
     vec3 N = normalize(TBN * finalNormalMapValue); 
 
-    // --- [޸ 1·λǿ ()] ---
-    // ·ǰ (Z=-4.0)߶΢͵ 5.0
-    //  Z=3.0պܿ·ǰˮľӰ
-    vec3 lightPos = vec3(0.0, 5.0, -4.0);
-    // ǿȴ 8.0  4.5ĳԹϹ
-    vec3 lightColor = vec3(0.8, 0.9, 1.0) * 4.5; 
-
-    vec3 lightDir = normalize(lightPos - FragPos);
-    vec3 V = normalize(viewPos - FragPos);
-    vec3 H = normalize(lightDir + V);
-
-    // --- [޸ 2ӿ˥] ---
-    float dist = length(lightPos - FragPos);
-    // Ӵϵù˥ø죬С̨
-    float attenuation = 1.0 / (1.0 + 0.09 * dist + 0.032 * dist * dist);
-
-    // --- [޸ 3С̨Դ (ڸظͼ)] ---
-    // [ؼ˼·] ֵĲԭ (0,0)·ڵͶӰ㣡
-    float distFromLight = length(FragPos.xz - lightPos.xz);
-    // ̨С뾶 2.5 ȫ 7.0 ״ױԨ (֮ǰ 5~12)
-    // ֻͬܿ 2~3 ظͼۼѲ
-    float spotlightMask = 1.0 - smoothstep(2.5, 6.0, distFromLight);
-
-    // 
-    float diff = max(dot(N, lightDir), 0.0);
-    vec3 diffuse = diff * finalAlbedo * lightColor;
-
-    // ߹
+    vec3 V = normalize(views[ViewIndex].position.xyz - FragPos);
     float shininess = (1.0 - finalRoughness) * 200.0; 
-    float spec = pow(max(dot(N, H), 0.0), shininess);
-    
     float F0 = mix(0.04, 0.02, puddleMask); 
     float fresnel = F0 + (1.0 - F0) * pow(1.0 - max(dot(V, N), 0.0), 5.0);
-    
-    vec3 specular = lightColor * spec * (fresnel + (1.0 - finalRoughness) * 0.5) * mix(1.0, 5.0, puddleMask); 
-
-    // յӰ
+    float specScale = (fresnel + (1.0 - finalRoughness) * 0.5) * mix(1.0, 5.0, puddleMask);
+
+    // 只遍历本簇内的路灯
+    vec3 direct = vec3(0.0);
+    float stageMask = 0.0;
+    for (uint i = 0u; i < cluster.y; ++i)
+    {
+        Light light = lights[lightIndices[cluster.x + i]];
+        vec3 lightPos = light.positionRange.xyz;
+        vec3 lightColor = light.color.rgb;
+        float range = light.positionRange.w;
+
+        // 光斑遮罩：中心是路灯在地面的投影点，保持原先 2.5 / 6.0 的内外半径比例
+        float distFromLight = length(FragPos.xz - lightPos.xz);
+        float spotlightMask = 1.0 - smoothstep(range * (2.5 / 6.0), range, distFromLight);
+        if (spotlightMask <= 0.0)
+            continue;
+
+        vec3 lightDir = normalize(lightPos - FragPos);
+        vec3 H = normalize(lightDir + V);
+
+        // 物理衰减 (二次项偏大，光衰减得更快)
+        float dist = length(lightPos - FragPos);
+        float attenuation = 1.0 / (1.0 + 0.09 * dist + 0.032 * dist * dist);
+
+        // 漫反射 + 高光
+        float diff = max(dot(N, lightDir), 0.0);
+        vec3 diffuse = diff * finalAlbedo * lightColor;
+        float spec = pow(max(dot(N, H), 0.0), shininess);
+        vec3 specular = lightColor * spec * specScale;
+
+        direct += (diffuse + specular) * attenuation * spotlightMask;
+        stageMask = max(stageMask, spotlightMask);
+    }
+
+    // 环境光与假天空倒影：只在有路灯照到的"舞台"上可见，舞台之外仍是深渊
     vec3 baseAmbient = vec3(0.01) * finalAlbedo * ao;
     vec3 fakeSkyReflect = vec3(0.02, 0.03, 0.05) * puddleMask; 
     vec3 ambient = baseAmbient + fakeSkyReflect;
 
-    // Ӧ˥
-    vec3 color = ambient + (diffuse + specular) * attenuation;
-    color *= spotlightMask;
+    vec3 color = ambient * stageMask + direct;
 
-    // ɫӳ Gamma У
+    // 色调映射与 Gamma 校正
     color = color / (color + vec3(1.0));
     color = pow(color, vec3(1.0/2.2));
 
@@ -1,26 +1,27 @@
-#version 460 core
+#version 450 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
-out vec3 FragPos;
-out vec2 TexCoords;
-out vec3 Normal;
+// 细分路径：顶点着色器只把 patch 控制点变换到世界空间，投影和位移交给 TCS / TES
+out vec3 WorldPos_CS;
+out vec2 TexCoords_CS;
+out vec3 Normal_CS;
+flat out int ViewIndex_CS;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform int viewCount;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    
-    // 򵥷߱任
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // 实例数 = 视图数，每个实例画一个视图
+    ViewIndex_CS = gl_InstanceID % viewCount;
+
+    WorldPos_CS = vec3(model * vec4(aPos, 1.0));
     
-    // [ؼ]  * 10.0öʯڵظƽ
-    // õ޴ģʯͷ
-    TexCoords = aTexCoords; 
+    // 简单法线变换
+    Normal_CS = mat3(transpose(inverse(model))) * aNormal;
     
-    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+    // 纹理坐标直接来自 patch 网格 (2 米一个纹理周期，让鹅卵石纹理在地面上重复平铺)
+    TexCoords_CS = aTexCoords; 
+}
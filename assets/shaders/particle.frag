@@ -1,16 +1,18 @@
-#version 460 core
+#version 450 core
 out vec4 FragColor;
 
 in vec2 TexCoord;
+in float Fade;
 uniform sampler2D particleTexture;
 
 void main()
 {
     vec4 texColor = texture(particleTexture, TexCoord);
+    texColor.a *= Fade;
     
-    // ޳͸Եֹ
+    // 剔除透明边缘，防止方块感
     if(texColor.a < 0.1) discard;
 
-    // ɫ˿ΣԴһ͸ (0.6)ǽʱȻ
-    FragColor = vec4(1.0, 1.0, 1.0, texColor.a * 0.7); // 뱳0.06
+    // 纯白色拉丝雨滴，略带一点透明度 (0.6)，让它们交叠时更自然
+    FragColor = vec4(1.0, 1.0, 1.0, texColor.a * 0.7); // 加入背景后可以0.06
 }
\ No newline at end of file
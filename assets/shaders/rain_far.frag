@@ -0,0 +1,36 @@
+#version 450 core
+out vec4 FragColor;
+
+in vec2 StreakUV;
+in float LayerAlpha;
+in float SheetHeight01;
+in vec3 EyeOffset;
+flat in int InnerLayer;
+
+uniform sampler2D streakTexture;
+
+// 与顶点阶段共用的 uniform (RainLayers::Config / RainEffect::Params)
+uniform float nearRadius;
+uniform float fadeWidth;
+uniform float sheetHeight;
+
+// 底部淡出的高度 (米)：雨幕和地面的交线不出现硬边
+const float BOTTOM_FADE = 1.0;
+
+void main()
+{
+    // 顶部淡出，抬头看时雨幕上沿不会出现硬边
+    float topFade = 1.0 - smoothstep(0.7, 1.0, SheetHeight01);
+    float bottomFade = smoothstep(0.0, BOTTOM_FADE / sheetHeight, SheetHeight01);
+
+    // 最内层按到相机的距离在 [nearRadius, nearRadius + fadeWidth] 内淡入，
+    // 与近景粒子在 [nearRadius - fadeWidth, nearRadius] 的淡出带首尾相接、等宽：
+    // 平视时这一层紧贴着最后一批淡出的雨滴，清晰的雨丝纹理在这里最容易露出接缝
+    float innerFade = InnerLayer == 1 ? smoothstep(nearRadius, nearRadius + fadeWidth, length(EyeOffset)) : 1.0;
+
+    float streak = texture(streakTexture, StreakUV).r * LayerAlpha * topFade * bottomFade * innerFade;
+    if (streak < 0.01) discard;
+
+    // 与近景雨滴同色 (纯白略透明)
+    FragColor = vec4(1.0, 1.0, 1.0, streak);
+}
@@ -0,0 +1,66 @@
+#version 450 core
+#extension GL_ARB_shader_viewport_layer_array : enable
+layout (location = 0) in vec2 aCylinder; // x = 绕圈比例 [0,1], y = 高度比例 [0,1]
+
+out vec2 StreakUV;
+out float LayerAlpha;
+out float SheetHeight01;   // 雨幕内的归一化高度，片元里做顶部 / 底部淡出
+out vec3 EyeOffset;        // 片元相对相机的世界坐标偏移，片元里算最内层的距离淡入 (线性插值是精确的)
+flat out int InnerLayer;   // 1 = 最内层
+
+uniform float time;
+
+// 多视图：所有视图的相机矩阵在一个 UBO 里 (见 MultiView.h)
+#define MAX_VIEWS 4
+struct ViewData {
+    mat4 view;
+    mat4 projection;
+    vec4 position;
+    vec4 viewport;   // x, y, width, height
+};
+layout(std140, binding = 0) uniform CameraViews { ViewData views[MAX_VIEWS]; };
+uniform int viewCount;
+
+// nearRadius 来自近景粒子的 RainEffect::Params，其余由 RainLayers::Config 提供
+uniform float nearRadius;
+uniform float layerSpacing;
+uniform float sheetHeight;
+uniform int layerCount;
+
+// 一张雨丝纹理对应的世界尺寸 (米)，与 RainLayers.cpp 生成纹理时的假设一致
+const vec2 TILE_SIZE = vec2(4.0, 8.0);
+// 远景雨的下落速度 (米/秒)，取近景雨滴 30~45 的中间值
+const float FALL_SPEED = 37.5;
+const float GROUND_HEIGHT = 0.0;
+
+void main()
+{
+    // 实例号 = 层 * viewCount + 视图；由远到近绘制：前 viewCount 个实例是最外层
+    int viewIndex = gl_InstanceID % viewCount;
+    int layer = layerCount - 1 - gl_InstanceID / viewCount;
+    // 雨幕中心跟随各自视图的相机 (立体时两眼各有一套同心圆柱，位移只有几厘米)
+    vec3 cameraPos = views[viewIndex].position.xyz;
+    float radius = nearRadius * pow(layerSpacing, float(layer));
+
+    // 圆柱跟随相机平移
+    float angle = aCylinder.x * 6.2831853;
+    float height = GROUND_HEIGHT + aCylinder.y * sheetHeight;
+    vec3 worldPos = vec3(cameraPos.x + cos(angle) * radius, height, cameraPos.z + sin(angle) * radius);
+
+    // 横向平铺次数取整，保证绕一圈首尾无缝；每层加不同偏移，避免各层雨丝对齐
+    float tiles = max(floor(6.2831853 * radius / TILE_SIZE.x), 1.0);
+    StreakUV = vec2(aCylinder.x * tiles + float(layer) * 0.37,
+                    (height + time * FALL_SPEED) / TILE_SIZE.y + float(layer) * 0.61);
+
+    SheetHeight01 = aCylinder.y;
+    EyeOffset = worldPos - cameraPos;
+    InnerLayer = layer == 0 ? 1 : 0;
+
+    // 越远越淡 (空气透视)
+    LayerAlpha = 0.55 / (1.0 + float(layer) * 0.6);
+
+    gl_Position = views[viewIndex].projection * views[viewIndex].view * vec4(worldPos, 1.0);
+#ifdef GL_ARB_shader_viewport_layer_array
+    gl_ViewportIndex = viewIndex;
+#endif
+}
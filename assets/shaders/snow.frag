@@ -0,0 +1,15 @@
+#version 450 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in float Fade;
+uniform sampler2D particleTexture;   // 和雨共用的径向渐变纹理
+
+void main()
+{
+    float alpha = texture(particleTexture, TexCoord).a * Fade;
+    if (alpha < 0.05) discard;
+
+    // 雪花比雨滴实，透明度给高一些
+    FragColor = vec4(0.95, 0.97, 1.0, alpha * 0.9);
+}
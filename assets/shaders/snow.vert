@@ -0,0 +1,54 @@
+#version 450 core
+#extension GL_ARB_shader_viewport_layer_array : enable
+// 粒子列的 SSBO 由 ParticleSystem<SnowEffect>::GetShaderDeclarations() 生成，插在 #extension 之后：
+//   layout(std430, binding = 4) readonly buffer ParticleColumn4 { vec4 positionScale[]; };
+//   layout(std430, binding = 5) readonly buffer ParticleColumn5 { float life[]; };
+layout (location = 0) in vec3 aPos; // 基础 Quad 顶点 (-0.5 到 0.5)
+
+out vec2 TexCoord;
+out float Fade;   // 边缘淡出 * 寿命淡出
+
+// 多视图：所有视图的相机矩阵在一个 UBO 里 (见 MultiView.h)
+#define MAX_VIEWS 4
+struct ViewData {
+    mat4 view;
+    mat4 projection;
+    vec4 position;
+    vec4 viewport;   // x, y, width, height
+};
+layout(std140, binding = 0) uniform CameraViews { ViewData views[MAX_VIEWS]; };
+uniform int viewCount;
+
+// 模拟半径与淡出带宽度 (SnowEffect::Params)
+uniform float radius;
+uniform float fadeWidth;
+
+// 雪花直径 (米)，乘以每片的随机缩放
+const float BaseSize = 0.12;
+
+void main()
+{
+    // 没有实例属性：相邻 viewCount 个实例是同一片雪的不同视图，粒子下标自己算
+    int viewIndex = gl_InstanceID % viewCount;
+    int particle = gl_InstanceID / viewCount;
+    vec4 instance = positionScale[particle];
+    vec3 cameraPos = views[viewIndex].position.xyz;
+
+    TexCoord = aPos.xy + 0.5;
+
+    // 靠近模拟圆柱边缘淡出，寿命最后一秒在空中化掉
+    float horizontalDist = length(instance.xz - cameraPos.xz);
+    Fade = (1.0 - smoothstep(radius - fadeWidth, radius, horizontalDist)) * clamp(life[particle], 0.0, 1.0);
+
+    // 正对相机的广告牌：右 / 上方向直接取视图矩阵的前两行
+    mat4 view = views[viewIndex].view;
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    float size = BaseSize * instance.w;
+    vec3 finalVertexPos = instance.xyz + (right * aPos.x + up * aPos.y) * size;
+
+    gl_Position = views[viewIndex].projection * view * vec4(finalVertexPos, 1.0);
+#ifdef GL_ARB_shader_viewport_layer_array
+    gl_ViewportIndex = viewIndex;
+#endif
+}
@@ -0,0 +1,30 @@
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+// --- 命令行配置 ---
+// 窗口模式和无头基准测试 (--bench) 共用一份：
+//   通用选项：--views N / --fps N / --gpu-budget MB / --weather rain|snow，两种模式都生效
+//   基准选项：--bench / --frames N / --warmup N / --size WxH / --keyframes N，只在基准模式下使用
+struct AppConfig
+{
+    enum class Weather { Rain, Snow };
+
+    // --- 通用 ---
+    unsigned int views = 1;           // 单趟多视图的视图数
+    float targetFps = 0.0f;           // FramePacer 的目标帧率，0 = 不限
+    unsigned int gpuBudgetMB = 0;     // GpuRegistry 的显存预算，0 = 不限
+    Weather weather = Weather::Rain;  // 近景粒子特效；雪没有远景雨幕
+
+    // --- 基准测试 ---
+    bool bench = false;
+    unsigned int frames = 600;
+    unsigned int warmupFrames = 10;   // 不计入统计 (首帧包含驱动的 shader 编译)
+    unsigned int width = 1280;        // 离屏渲染目标的尺寸
+    unsigned int height = 720;
+    unsigned int keyFrameCount = 5;   // 均匀分布在整段路径上 (含最后一帧)
+    float fixedDeltaTime = 1.0f / 60.0f;
+
+    static AppConfig FromArgs(int argc, char** argv);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// --- 资源包 (assets.pak) 的磁盘格式 ---
+// 打包工具 (tools/AssetPacker.cpp) 和运行时 VFS 共用这一份定义。
+//
+//   [Header]                     64 字节
+//   [Entry * entryCount]         按 pathHash 升序，运行时二分查找
+//   [路径字符串表]               每条路径以 '\0' 结尾，方便直接当 C 字符串用
+//   [数据区]                     每个条目起始按 DATA_ALIGNMENT 对齐
+//
+// 所有整数都是小端序；整个文件被 mmap 后，索引和数据都直接原地访问，不做任何拷贝。
+namespace AssetArchive
+{
+    const uint32_t MAGIC = 0x4B50434Bu;   // "KCPK"
+    const uint32_t VERSION = 1;
+    const uint32_t DATA_ALIGNMENT = 64;  // cache line；纹理数据可以直接交给解码器/GL 按行读取
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t dataAlignment;
+        uint64_t indexOffset;    // Entry 数组起点
+        uint64_t stringsOffset;  // 路径字符串表起点
+        uint64_t dataOffset;     // 数据区起点
+        uint64_t fileSize;
+        uint8_t reserved[16];
+    };
+
+    struct Entry
+    {
+        uint64_t pathHash;       // 相对路径 ("assets/shaders/ground.frag") 的 FNV-1a
+        uint64_t contentHash;    // 数据的 FNV-1a，首次访问时校验
+        uint64_t offset;         // 相对文件开头
+        uint64_t size;
+        uint32_t pathOffset;     // 相对字符串表起点
+        uint32_t pathLength;
+    };
+
+    static_assert(sizeof(Header) == 64, "archive header layout");
+    static_assert(sizeof(Entry) == 40, "archive entry layout");
+
+    // 64 位 FNV-1a：实现简单、无依赖，打包工具和运行时结果一致
+    inline uint64_t Hash(const void* data, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Camera.h"
+#include "RenderQueue.h"
+#include "ColumnArena.h"
+#include "GpuResources.h"
+#include "AppConfig.h"
+
+struct GLFWwindow;
+
+// --- 无头基准测试 (--bench) ---
+// 在没有 GPU 的构建机上用软件 GL 跑固定的相机脚本，
+// 输出每个 pass 的帧时间分布、draw/状态切换次数，以及关键帧的感知哈希。
+// 选项见 AppConfig 的基准测试部分。
+
+// 无头 GL 上下文
+// 依次尝试：EGL surfaceless (Mesa llvmpipe，无需显示服务器) ->
+//          GLFW null 平台 + OSMesa -> 默认平台上的隐藏窗口
+class HeadlessContext
+{
+public:
+    static std::unique_ptr<HeadlessContext> Create(const AppConfig& config);
+    ~HeadlessContext();
+
+    // 交给 gladLoadGLLoader 的函数加载器
+    GLADloadproc Loader() const;
+
+private:
+    HeadlessContext() = default;
+
+    GLFWwindow* window = nullptr;
+    void* eglDisplay = nullptr;
+    void* eglContext = nullptr;
+};
+
+// 确定性的相机脚本路径：关键帧之间做平滑插值，t 取 [0, 1]
+class CameraPath
+{
+public:
+    struct Keyframe
+    {
+        glm::vec3 position;
+        float yaw;
+        float pitch;
+    };
+
+    explicit CameraPath(std::vector<Keyframe> keys);
+
+    // 默认路径：从初始机位出发，绕路灯走一圈再拉高俯视
+    static CameraPath Default();
+
+    void Apply(Camera& camera, float t) const;
+
+private:
+    std::vector<Keyframe> keys;
+};
+
+// 分 pass 计时 (GL_TIME_ELAPSED 查询)
+// 基准模式每帧都会 glFinish，所以结果在帧末可直接读取，不需要多帧环形缓冲
+// 注意：在软件光栅 (llvmpipe 等) 上这是驱动在 CPU 上光栅化的耗时，不是 GPU 时间，
+// 报告会按 GL_RENDERER 标注 (见 BenchReport::SetRenderer)
+class GpuPassTimer
+{
+public:
+    explicit GpuPassTimer(unsigned int passCount);
+    ~GpuPassTimer();
+
+    void Begin(unsigned int pass);
+    void End();
+
+    // 读取本帧每个 pass 的耗时 (毫秒)
+    void Collect(std::vector<float>& passMs);
+
+private:
+    std::vector<unsigned int> queries;
+};
+
+// 离屏渲染目标：RGBA8 颜色 + 24 位深度
+class OffscreenTarget
+{
+public:
+    OffscreenTarget(unsigned int width, unsigned int height);
+    ~OffscreenTarget();
+
+    void Bind();
+    // 读回颜色缓冲 (RGBA8，行从下往上)
+    void ReadPixels(std::vector<unsigned char>& pixels);
+
+    unsigned int Width() const { return width; }
+    unsigned int Height() const { return height; }
+
+private:
+    unsigned int width, height;
+    unsigned int FBO;
+    GpuRenderbuffer colorRBO;   // 登记在 GpuRegistry，计入显存预算
+    GpuRenderbuffer depthRBO;
+};
+
+// 64 位差值哈希 (dHash)：缩到 9x8 灰度后比较相邻像素
+// 对轻微的光栅化差异不敏感，用汉明距离判断画面是否回归
+uint64_t PerceptualHash(const std::vector<unsigned char>& rgba, unsigned int width, unsigned int height);
+
+// 收集样本并打印分布 (p50 / p95 / p99 / max)
+class BenchReport
+{
+public:
+    explicit BenchReport(std::vector<std::string> passNames);
+
+    // 记录 GL_RENDERER；前 queryPassCount 个 pass 来自 GpuPassTimer，其余是 CPU 计时
+    // 软件光栅时查询结果只是 CPU 光栅化耗时 (而且噪声很大)，打印时不当作 GPU 时间
+    void SetRenderer(const std::string& renderer, size_t queryPassCount);
+
+    void AddFrame(float frameMs, const std::vector<float>& passMs, const RenderStats& stats);
+    void AddKeyFrame(unsigned int frame, uint64_t hash);
+    void AddArenaStats(const std::string& name, const ColumnArena::Stats& stats);
+    void Print() const;
+
+private:
+    std::vector<std::string> passNames;
+    std::string renderer;
+    bool softwareRenderer = false;
+    size_t queryPassCount = 0;
+    std::vector<float> frameSamples;
+    std::vector<std::vector<float>> passSamples;
+    std::vector<RenderStats> statSamples;
+    std::vector<std::pair<unsigned int, uint64_t>> keyFrames;
+    std::vector<std::pair<std::string, ColumnArena::Stats>> arenas;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef COLUMNARENA_H
+#define COLUMNARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// --- 模拟列的内存竞技场 (Arena) ---
+// 粒子列一次性从一整块大内存里切出来：
+//   1. 每列 64 字节 (cache line) 对齐，元素个数补齐到 SIMD 宽度，热循环不需要处理尾巴
+//   2. 整块内存优先用大页 (MAP_HUGETLB 显式大页 -> madvise 透明大页 -> 普通页)，
+//      几千万个粒子时 TLB miss 大幅减少
+//   3. Reserve 时在调用线程上完成首次写入 (first touch)，也就是之后执行 Update 的线程，
+//      Linux 的 first-touch 策略会把物理页放在该线程所在的 NUMA 节点上
+class ColumnArena
+{
+public:
+    static constexpr size_t ALIGNMENT = 64;            // cache line
+    static constexpr size_t SIMD_BYTES = 64;           // AVX-512 一个寄存器
+    static constexpr size_t HUGE_PAGE_SIZE = 2u << 20; // 2 MB
+
+    enum class HugePages { None, Transparent, Explicit };
+
+    struct Options
+    {
+        HugePages hugePages = HugePages::Explicit;  // 请求的最高级别，失败逐级回退
+        size_t chunkBytes = HUGE_PAGE_SIZE;         // NUMA 统计的采样粒度 (Stats::chunksPerNode)
+    };
+
+    struct Stats
+    {
+        size_t reservedBytes = 0;
+        size_t usedBytes = 0;
+        size_t paddingBytes = 0;      // 对齐 + SIMD 补齐浪费的字节
+        size_t allocations = 0;
+        HugePages hugePages = HugePages::None;  // 实际拿到的页类型
+        std::vector<size_t> chunksPerNode;      // 每个 NUMA 节点上的块数 (按块首页采样，仅 Linux)
+    };
+
+    ColumnArena() = default;
+    ~ColumnArena();
+
+    ColumnArena(const ColumnArena&) = delete;
+    ColumnArena& operator=(const ColumnArena&) = delete;
+
+    // 一次性预留整块内存并完成 first touch (清零)
+    bool Reserve(size_t bytes, const Options& options);
+
+    // 切出一列：返回 64 字节对齐、已清零的内存；count 会被补齐到 SIMD 宽度
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "arena columns must be trivially copyable");
+        static_assert(alignof(T) <= ALIGNMENT, "column element over-aligned");
+        return static_cast<T*>(AllocateBytes(PaddedCount(count, sizeof(T)) * sizeof(T), count * sizeof(T)));
+    }
+
+    // 补齐后的元素个数：列的总字节数是 SIMD_BYTES 的整数倍
+    static size_t PaddedCount(size_t count, size_t elementSize);
+
+    // 一列补齐后占用的字节数 (含对齐)，用于事先计算 Reserve 的大小
+    template<typename T>
+    static size_t ColumnBytes(size_t count)
+    {
+        return (PaddedCount(count, sizeof(T)) * sizeof(T) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // 查询当前的统计信息 (chunksPerNode 会现场向内核查询)
+    Stats GetStats() const;
+
+private:
+    void* AllocateBytes(size_t bytes, size_t requestedBytes);
+    void Release();
+
+    unsigned char* base = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t chunkSize = HUGE_PAGE_SIZE;
+    Stats stats;
+};
+
+const char* ToString(ColumnArena::HugePages mode);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <glad/glad.h>
+
+// --- 帧节奏控制 (Frame Pacing) ---
+// 关掉垂直同步后，CPU 可以比 GPU 快好几帧，命令在驱动队列里越堆越深，
+// 鼠标输入要排完整个队列才上屏。这里每帧做三件事：
+//   1. 队列深度限制：每帧提交后插一个 fence，在途的帧达到 maxFramesInFlight 时等最老的那个
+//   2. 目标帧率：先 sleep 到截止时间前 spinMarginMs，剩下的一小段自旋 (sleep 的唤醒误差有 1~2ms)
+//   3. 统计：输入采样 -> 提交完成的延迟，以及帧间隔的抖动 (标准差)
+// 相机矩阵的"晚锁存"由调用方配合：模拟更新、组装完绘制之后再轮询一次输入，紧接着写 MultiView 的 UBO 并执行队列。
+class FramePacer
+{
+public:
+    struct Config
+    {
+        float targetFps = 0.0f;              // 0 = 不限帧率 (只做队列深度限制)
+        float spinMarginMs = 2.0f;           // 截止时间前的这一段用自旋代替 sleep
+        unsigned int maxFramesInFlight = 2;  // GPU 队列里最多同时有几帧
+    };
+
+    struct Stats
+    {
+        unsigned int frames = 0;
+        float latencyMeanMs = 0.0f;    // 输入采样 -> 提交完成
+        float latencyP99Ms = 0.0f;
+        float latencyMaxMs = 0.0f;
+        float intervalMeanMs = 0.0f;   // 相邻两帧开始时刻的间隔
+        float intervalP99Ms = 0.0f;
+        float jitterMs = 0.0f;         // 帧间隔的标准差
+        unsigned int fenceWaits = 0;   // 因队列已满而等待的次数
+        float fenceWaitMs = 0.0f;      // 等待的总时长
+    };
+
+    explicit FramePacer(const Config& config);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 帧开始：限制队列深度，再等到本帧的截止时间
+    void BeginFrame();
+
+    // 记录本帧实际使用的输入在何时采样 (晚锁存点)
+    void MarkInput();
+
+    // 本帧的命令全部提交之后调用 (交换缓冲之前)
+    void EndFrame();
+
+    const Config& GetConfig() const { return config; }
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Config config;
+    std::deque<GLsync> inFlight;
+
+    Clock::time_point deadline;
+    Clock::time_point lastFrameStart;
+    Clock::time_point inputTime;
+    bool started = false;
+    bool hasInput = false;
+
+    // 只保留最近的样本，长时间运行也不会无限增长
+    static const size_t SAMPLE_WINDOW = 4096;
+    std::vector<float> latencySamples;
+    std::vector<float> intervalSamples;
+    size_t latencyCursor = 0;
+    size_t intervalCursor = 0;
+    unsigned int frames = 0;
+    unsigned int fenceWaits = 0;
+    float fenceWaitMs = 0.0f;
+
+    void waitUntil(Clock::time_point target) const;
+    static void addSample(std::vector<float>& samples, size_t& cursor, float value);
+};
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef GPURESOURCES_H
+#define GPURESOURCES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <glad/glad.h>
+
+// --- GPU 资源登记表 ---
+// 所有 buffer / 纹理 / 渲染缓冲 / VAO 都通过下面的 RAII 句柄创建，句柄在构造时登记、析构时删除并注销：
+//   1. 每个对象记录大小、格式和所属模块 (owner)，随时可以查询显存总量
+//   2. 超出预算时 Enforce() 给允许降级的纹理丢掉最高一级 mip (每次省约 3/4)，
+//      直到回到预算以内或没有可降级的纹理；其余对象都是常驻的，不会被释放
+//   3. 所有句柄析构之后仍然登记在册的对象就是泄漏，main 在销毁上下文之前调用 ReportLeaks 打印出来
+// 大小是按格式估算的逻辑大小，不含驱动的对齐和元数据。
+enum class GpuResourceKind : uint8_t { Buffer, Texture, Renderbuffer, VertexArray };
+
+enum class GpuResidency : uint8_t
+{
+    Pinned,         // 常驻，预算紧张时也不动
+    MipDroppable,   // 纹理：可以丢掉最高一级 mip
+};
+
+class GpuRegistry
+{
+public:
+    static const int MIN_DROP_SIZE = 256;       // 纹理降到这个尺寸以下就不再丢 mip
+
+    struct Entry
+    {
+        GpuResourceKind kind;
+        unsigned int id;
+        std::string owner;
+        GpuResidency residency = GpuResidency::Pinned;
+        size_t bytes = 0;
+        GLenum format = 0;          // buffer: usage / storage 标志；纹理 / 渲染缓冲: 内部格式
+        int width = 0;              // 纹理 level 0 / 渲染缓冲的尺寸
+        int height = 0;
+        int levels = 0;
+    };
+
+    struct Totals
+    {
+        size_t bufferBytes = 0;
+        size_t textureBytes = 0;    // 纹理 + 渲染缓冲 (图像内存)
+        size_t peakBytes = 0;
+        unsigned int buffers = 0;
+        unsigned int textures = 0;
+        unsigned int renderbuffers = 0;
+        unsigned int vertexArrays = 0;
+        unsigned int mipDrops = 0;
+
+        size_t Bytes() const { return bufferBytes + textureBytes; }
+    };
+
+    static GpuRegistry& Get();
+
+    GpuRegistry(const GpuRegistry&) = delete;
+    GpuRegistry& operator=(const GpuRegistry&) = delete;
+
+    void Register(GpuResourceKind kind, unsigned int id, const std::string& owner, GpuResidency residency = GpuResidency::Pinned);
+    void Unregister(GpuResourceKind kind, unsigned int id);
+
+    // 记录 buffer 的分配大小
+    void SetBufferSize(unsigned int id, size_t bytes, GLenum format);
+    // 重新查询纹理各级 mip 的尺寸和格式 (纹理内容重新指定后调用)
+    void RefreshTexture(unsigned int id);
+    // 记录渲染缓冲的格式和尺寸
+    void SetRenderbufferSize(unsigned int id, GLenum internalFormat, int width, int height);
+
+    // 预算 (字节)，0 = 不限
+    void SetBudget(size_t bytes) { budget = bytes; }
+    size_t GetBudget() const { return budget; }
+    bool OverBudget() const { return budget != 0 && totals.Bytes() > budget; }
+
+    // 超出预算时降级，直到回到预算以内或无事可做；返回省下的字节数
+    size_t Enforce();
+
+    const Totals& GetTotals() const { return totals; }
+    const Entry* Find(GpuResourceKind kind, unsigned int id) const;
+
+    // 打印仍然存活的对象，返回个数 (需在上下文销毁之前调用，这时对象名还有意义)
+    size_t ReportLeaks() const;
+
+private:
+    GpuRegistry() = default;
+
+    static uint64_t makeKey(GpuResourceKind kind, unsigned int id)
+    {
+        return (static_cast<uint64_t>(kind) << 32) | id;
+    }
+
+    void setBytes(Entry& entry, size_t bytes);
+    size_t dropTopMip(Entry& entry);
+
+    std::unordered_map<uint64_t, Entry> entries;
+    Totals totals;
+    size_t budget = 0;
+    bool warnedBudget = false;
+};
+
+// --- RAII 句柄 ---
+// 只能移动不能复制；析构时删除 GL 对象并从登记表注销。
+// 默认构造的句柄是空的 (ID() == 0)，用于可选的资源。
+class GpuHandle
+{
+public:
+    GpuHandle(const GpuHandle&) = delete;
+    GpuHandle& operator=(const GpuHandle&) = delete;
+    GpuHandle(GpuHandle&& other) noexcept;
+    GpuHandle& operator=(GpuHandle&& other) noexcept;
+    ~GpuHandle() { Reset(); }
+
+    unsigned int ID() const { return id; }
+    explicit operator bool() const { return id != 0; }
+
+    // 删除对象，句柄变空
+    void Reset();
+
+protected:
+    explicit GpuHandle(GpuResourceKind kind) : kind(kind) {}
+    GpuHandle(GpuResourceKind kind, unsigned int id, const std::string& owner, GpuResidency residency);
+
+    GpuResourceKind kind;
+    unsigned int id = 0;
+};
+
+class GpuBuffer : public GpuHandle
+{
+public:
+    GpuBuffer() : GpuHandle(GpuResourceKind::Buffer) {}
+    explicit GpuBuffer(const std::string& owner, GpuResidency residency = GpuResidency::Pinned);
+
+    // 可变存储 (glNamedBufferData)，可以多次调用重新分配
+    void Allocate(size_t bytes, const void* data, GLenum usage);
+    // 不可变存储 (glNamedBufferStorage)，只能调用一次
+    void Storage(size_t bytes, const void* data, GLbitfield flags);
+};
+
+class GpuTexture : public GpuHandle
+{
+public:
+    GpuTexture() : GpuHandle(GpuResourceKind::Texture) {}
+
+    // 接管一个已经指定好内容的 GL_TEXTURE_2D (loadTexture 等返回的名字)
+    static GpuTexture Adopt(unsigned int id, const std::string& owner, GpuResidency residency = GpuResidency::Pinned);
+
+private:
+    GpuTexture(unsigned int id, const std::string& owner, GpuResidency residency)
+        : GpuHandle(GpuResourceKind::Texture, id, owner, residency) {}
+};
+
+class GpuRenderbuffer : public GpuHandle
+{
+public:
+    GpuRenderbuffer() : GpuHandle(GpuResourceKind::Renderbuffer) {}
+    explicit GpuRenderbuffer(const std::string& owner);
+
+    // 分配存储 (glNamedRenderbufferStorage)，可以多次调用重新分配
+    void Storage(GLenum internalFormat, int width, int height);
+};
+
+class GpuVertexArray : public GpuHandle
+{
+public:
+    GpuVertexArray() : GpuHandle(GpuResourceKind::VertexArray) {}
+    explicit GpuVertexArray(const std::string& owner);
+};
+
+#endif
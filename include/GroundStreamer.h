@@ -0,0 +1,129 @@
+#ifndef GROUNDSTREAMER_H
+#define GROUNDSTREAMER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "GpuResources.h"
+
+// --- 地面分块流式加载 (Ground Streaming) ---
+// 地面不再是固定的 50x50 平面，而是以相机为中心的一圈 TILE_SIZE 见方的地块：
+//   1. 可见圈：相机所在地块周围 VISIBLE_RADIUS 圈，缺的地块优先请求
+//   2. 预取圈：按相机速度外推 PREFETCH_SECONDS 秒后的位置，请求那里同样大小的一圈，走到之前就已经在池里
+//   3. 地块的 patch 网格由后台线程生成，主线程每帧只取走已经完成的结果，
+//      最多上传 UPLOADS_PER_FRAME 块，从不等待生成 (还没到的可见地块这一帧先不画)
+//   4. GPU 端是启动时一次分配好的 SLOT_COUNT 个槽 (同一个 buffer 的不同区段)，
+//      新地块覆盖最久没被用到的槽 (LRU)，运行期间不再分配显存；
+//      最近 framesInFlight 帧用过的槽 GPU 可能还在读 (FramePacer 的队列深度)，不参与覆盖
+// 每个地块是 PATCHES_PER_TILE x PATCHES_PER_TILE 个四边形 patch，顶点格式与原来的地面平面相同
+// (pos, normal, uv)，uv 按世界坐标计算，相邻地块的纹理无缝衔接。
+// 材质 (PBR 纹理) 所有地块共用，按世界坐标平铺，所以池里只需要放网格。
+class GroundStreamer
+{
+public:
+    static constexpr float TILE_SIZE = 12.5f;              // 米
+    static const unsigned int PATCHES_PER_TILE = 4;        // patch 边长 3.125 米，与原来的 16x16 网格一致
+    static const int VISIBLE_RADIUS = 2;                   // 5x5 块，覆盖相机周围约 60 米
+    static constexpr float PREFETCH_SECONDS = 1.0f;
+    static const unsigned int SLOT_COUNT = 64;             // 可见圈 + 预取圈最多 50 块，留一些给刚离开的地块
+    static const unsigned int UPLOADS_PER_FRAME = 4;
+    static const unsigned int MAX_PENDING = 16;            // 后台队列里最多积压的请求数
+
+    static const unsigned int FLOATS_PER_VERTEX = 8;
+    static const unsigned int VERTICES_PER_TILE = PATCHES_PER_TILE * PATCHES_PER_TILE * 4;
+
+    struct Stats
+    {
+        uint64_t lookups = 0;      // 可见地块的查询次数 (每帧每块一次)
+        uint64_t hits = 0;         // 其中已经在池里的
+        uint64_t requests = 0;     // 提交给后台线程的生成请求
+        uint64_t uploads = 0;
+        uint64_t evictions = 0;    // 覆盖了一个仍有效地块的上传
+        uint64_t discarded = 0;    // 生成好了但没有可用的槽 (池里全是在途帧还在读的)
+        unsigned int resident = 0;
+
+        float HitRate() const { return lookups ? static_cast<float>(hits) / lookups : 0.0f; }
+    };
+
+    // 本帧要画的一个地块：首顶点 (顶点数为 VERTICES_PER_TILE) + 地块中心的世界 XZ (用于排序)
+    struct DrawTile
+    {
+        unsigned int first;
+        glm::vec2 center;
+    };
+
+    // framesInFlight 传 FramePacer::Config::maxFramesInFlight
+    explicit GroundStreamer(unsigned int framesInFlight);
+    ~GroundStreamer();
+
+    GroundStreamer(const GroundStreamer&) = delete;
+    GroundStreamer& operator=(const GroundStreamer&) = delete;
+
+    // 启动时同步生成相机周围的可见圈 (此时还没有帧，阻塞无妨)
+    void Prefill(const glm::vec3& cameraPos);
+
+    // 每帧调用：估计速度、请求缺失地块、上传已完成的结果、更新本帧的绘制列表
+    void Update(const glm::vec3& cameraPos, float dt);
+
+    unsigned int GetVAO() const { return VAO.ID(); }
+    const std::vector<DrawTile>& GetDrawTiles() const { return drawTiles; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct TileData
+    {
+        glm::ivec2 coord;
+        std::vector<float> vertices;
+    };
+
+    struct Slot
+    {
+        glm::ivec2 coord;
+        bool valid = false;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    static uint64_t makeKey(glm::ivec2 coord)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.y);
+    }
+    static glm::ivec2 tileOf(const glm::vec3& position);
+    static void generateTile(glm::ivec2 coord, std::vector<float>& vertices);
+
+    void request(glm::ivec2 coord);
+    void addDrawTile(unsigned int slot, glm::ivec2 coord);
+    void upload(TileData& tile);
+    void workerLoop();
+
+    GpuVertexArray VAO;
+    GpuBuffer pool;
+
+    std::vector<Slot> slots;
+    std::unordered_map<uint64_t, unsigned int> residentSlots;   // 地块 -> 槽号
+    std::unordered_set<uint64_t> pending;                       // 已请求、尚未上传
+    std::vector<DrawTile> drawTiles;
+
+    glm::vec3 lastPosition = glm::vec3(0.0f);
+    glm::vec3 velocity = glm::vec3(0.0f);
+    bool hasPosition = false;
+    uint64_t frame = 0;
+    unsigned int framesInFlight;
+    Stats stats;
+
+    // --- 后台线程 ---
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<glm::ivec2> requests;     // 受 mutex 保护
+    std::vector<TileData> completed;     // 受 mutex 保护
+    bool stopping = false;               // 受 mutex 保护
+};
+
+#endif
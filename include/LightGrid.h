@@ -0,0 +1,89 @@
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include <vector>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "MultiView.h"
+#include "GpuResources.h"
+
+// 路灯 (点光源 + 地面上的水平光斑范围)
+struct PointLight
+{
+    glm::vec3 position;
+    glm::vec3 color;        // 已乘强度
+    float range;            // 光斑半径：水平距离超过 range 的地面完全不受影响
+    float radius;           // 分簇用的包围球半径 (需包住整个受光区域)
+};
+
+// --- 分簇前向光照 (Clustered Forward) ---
+// 把视锥切成 X x Y 个屏幕 tile、Z 方向按指数切片的 froxel 网格，
+// 每帧在 CPU 上把每盏灯挂到它包围球覆盖的簇里，结果以 SSBO 交给 ground.frag：
+//   binding 0: 灯光数组        { vec4 positionRange; vec4 color; }
+//   binding 1: 每簇的区间      { uint offset; uint count; }，按视图依次排列 (view * CLUSTER_COUNT + 簇号)
+//   binding 2: 灯光下标列表    uint[]
+//   binding 3: 网格参数        { uvec4 dims (X, Y, Z, 视图数); vec4 params (zScale, zBias, -, -) }
+// 片元只遍历自己所在簇的灯，空簇直接跳过整个着色。
+// 多视图时每个视图各有一套簇 (tile 相对该视图的视口)，灯光数组共用。
+class LightGrid
+{
+public:
+    static const unsigned int GRID_X = 16;
+    static const unsigned int GRID_Y = 9;
+    static const unsigned int GRID_Z = 24;
+    static const unsigned int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    LightGrid();
+
+    // 重新分簇 (每帧相机变化后调用)，每个视图一套簇
+    void Build(const std::vector<PointLight>& lights, const std::vector<RenderView>& views, float zNear, float zFar);
+
+    // 上传并绑定到 binding 0..3
+    void Upload();
+
+    // 统计：灯-簇对数量 / 非空簇数量
+    unsigned int GetLightClusterPairs() const { return static_cast<unsigned int>(lightIndices.size()); }
+    unsigned int GetActiveClusters() const { return activeClusters; }
+
+private:
+    struct GpuLight
+    {
+        glm::vec4 positionRange;
+        glm::vec4 color;
+    };
+
+    struct ClusterRange
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    struct GridParams
+    {
+        glm::uvec4 dims;
+        glm::vec4 params;
+    };
+
+    // 每盏灯在某个视图里覆盖的簇范围 (闭区间)
+    struct LightBounds
+    {
+        unsigned int view;
+        unsigned int x0, x1, y0, y1, z0, z1;
+    };
+
+    std::vector<GpuLight> gpuLights;
+    std::vector<ClusterRange> clusters;
+    std::vector<uint32_t> lightIndices;
+    std::vector<LightBounds> bounds;
+    std::vector<uint32_t> boundsLight;   // 与 bounds 对应的灯光下标
+    GridParams gridParams;
+    unsigned int activeClusters = 0;
+
+    GpuBuffer SSBO[4];
+    size_t capacity[4];
+
+    void uploadBuffer(unsigned int index, const void* data, size_t bytes);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef MULTIVIEW_H
+#define MULTIVIEW_H
+
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "GpuResources.h"
+
+// 一个视图：相机矩阵 + 它在帧缓冲里占的视口
+struct RenderView
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 position;
+    glm::vec4 viewport;   // x, y, width, height (像素)
+};
+
+// --- 单趟多视图 (Single-pass Multiview) ---
+// 多块屏幕 / 立体双目共用同一份模拟和实例数据，每个 pass 只提交一次绘制：
+//   1. 所有视图的矩阵放在一个 UBO 里 (binding 0, std140)：
+//        struct ViewData { mat4 view; mat4 projection; vec4 position; vec4 viewport; } views[MAX_VIEWS];
+//      UBO 持久映射成 RING_SIZE 块轮流写，CPU 写这一帧时 GPU 还可以读前几帧的，
+//      所以 Upload 可以放在提交绘制的前一刻 (晚锁存最新的鼠标输入) 而不引起同步
+//   2. 绘制的实例数乘以视图数，顶点着色器里 view = gl_InstanceID % viewCount，
+//      原来的实例号 = gl_InstanceID / viewCount (实例属性的 divisor 相应设为 viewCount)
+//   3. 顶点着色器写 gl_ViewportIndex (GL_ARB_shader_viewport_layer_array)，
+//      由视口数组把每个视图的图元送到自己的屏幕区域
+// 不支持该扩展时只保留第一个视图。
+class MultiView
+{
+public:
+    static const unsigned int MAX_VIEWS = 4;   // 与各 shader 里的 MAX_VIEWS 一致
+    static const unsigned int UBO_BINDING = 0;
+    static const unsigned int RING_SIZE = 3;   // 需大于 FramePacer 的 maxFramesInFlight
+
+    MultiView();
+    ~MultiView();
+
+    MultiView(const MultiView&) = delete;
+    MultiView& operator=(const MultiView&) = delete;
+
+    // 当前上下文能否在顶点着色器里写 gl_ViewportIndex
+    static bool IsSupported();
+
+    // 设置本帧的视图 (超出 MAX_VIEWS 或不支持多视图时截断)
+    void SetViews(const std::vector<RenderView>& views);
+
+    // 写入 UBO 的下一块区域、绑定到 UBO_BINDING，并设置视口数组 (每帧一次，紧挨着提交绘制)
+    void Upload();
+
+    const std::vector<RenderView>& GetViews() const { return views; }
+    unsigned int GetViewCount() const { return static_cast<unsigned int>(views.size()); }
+
+    // 把一个相机按视图数横向切分视口，相邻视图沿 right 方向错开 separation (立体 / 多屏拼接)
+    static std::vector<RenderView> SideBySide(unsigned int count, const glm::vec3& position, const glm::vec3& front,
+        const glm::vec3& up, const glm::vec3& right, float fovY, float width, float height,
+        float zNear, float zFar, float separation);
+
+private:
+    struct GpuView
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 position;
+        glm::vec4 viewport;
+    };
+
+    std::vector<RenderView> views;
+    GpuBuffer UBO;
+    unsigned int maxViews;
+
+    unsigned char* mapped = nullptr;
+    size_t regionSize = 0;
+    unsigned int region = 0;
+    bool uploaded = false;
+    GLsync fences[RING_SIZE];
+};
+
+#endif
@@ -3,22 +3,41 @@
 
 #include <glm/glm.hpp>
 
-enum class ParticleState {
-    Falling,
-    Splashing
-};
-
-struct Particle {
-    glm::vec3 Position; 
-    glm::vec3 Velocity; 
-    glm::vec4 Color;    
-    float Life;         
-    ParticleState State; 
-
-    // ĬϹ캯ʼ
-    Particle()
-        : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) {
-    }
-};
-
-#endif
\ No newline at end of file
+// --- 粒子属性列 (Column Tag) ---
+// 不再用一个大而全的 Particle 结构体，每种特效只挑自己需要的列组成类型列表，
+// 由 ParticleStorage 生成 SoA 存储。
+// location >= 0：实例属性，每帧上传到 GPU，对应 shader 里的 layout (location = N)
+// location <  0：只在 CPU 模拟中使用，不占显存和带宽
+// name 是生成的 GLSL 声明里的变量名 (实例属性或 SSBO 数组，见 ParticleLayout.h)
+namespace ParticleAttr {
+
+    // xyz = 世界坐标，w = 随机缩放 (决定粗细大小)
+    struct PositionScale {
+        using type = glm::vec4;
+        static constexpr int location = 2;
+        static constexpr const char* name = "positionScale";
+    };
+
+    struct Velocity {
+        using type = glm::vec3;
+        static constexpr int location = -1;
+        static constexpr const char* name = "velocity";
+    };
+
+    // 剩余寿命 (秒)，归零前的最后一秒在 shader 里淡出
+    struct Life {
+        using type = float;
+        static constexpr int location = 3;
+        static constexpr const char* name = "life";
+    };
+
+    // 飘动相位 (弧度)，只在 CPU 上推进
+    struct Phase {
+        using type = float;
+        static constexpr int location = -1;
+        static constexpr const char* name = "phase";
+    };
+
+}
+
+#endif
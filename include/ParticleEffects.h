@@ -0,0 +1,172 @@
+#ifndef PARTICLEEFFECTS_H
+#define PARTICLEEFFECTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <glm/glm.hpp>
+#include "Particle.h"
+#include "ParticleLayout.h"
+
+// --- 特效定义 ---
+// 每个特效 = 属性列类型列表 + GPU 取数方式 (Fetch) + 参数 (Params) + Spawn (初始化单个粒子) + Update (整列更新的热循环)。
+// ParticleSystem<Effect> 在编译期把这两个函数内联进自己的实现，没有虚函数，也没有多余的列。
+
+inline float randomFloat(float min, float max) {
+    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+}
+
+// 在以 center 为圆心、radius 为半径的圆盘内均匀取点
+inline glm::vec2 randomInDisk(glm::vec2 center, float radius)
+{
+    float angle = randomFloat(0.0f, 6.2831853f);
+    float r = radius * std::sqrt(randomFloat(0.0f, 1.0f));
+    return center + glm::vec2(std::cos(angle), std::sin(angle)) * r;
+}
+
+// 地面高度 (与 GroundStreamer 生成的地块 y 一致)
+const float GROUND_HEIGHT = 0.0f;
+
+// 雨：只有位置 + 速度两列，就是原先手写的那套 SoA
+// 只模拟相机周围 nearRadius 以内的近景雨滴，更远处交给 RainLayers 的滚动雨幕
+struct RainEffect
+{
+    using Columns = ColumnList<ParticleAttr::PositionScale, ParticleAttr::Velocity>;
+    using Storage = ParticleStorage<Columns>;
+    static constexpr ParticleFetch Fetch = ParticleFetch::InstanceAttrib;
+
+    // 粒子系统持有这一份，RainLayers 构造时从 ParticleSystem::GetParams() 取第一层半径和淡出带
+    struct Params
+    {
+        float nearRadius = 12.0f;    // 近景半径 (米)
+        float fadeWidth = 3.0f;      // 边缘淡出带宽度，与 particle.vert 的 Fade 一致
+    };
+
+    static void Spawn(Storage& s, size_t i, const Params& params)
+    {
+        glm::vec2 xz = randomInDisk(glm::vec2(0.0f), params.nearRadius);
+        // [修改] 高度范围从 0~40 压缩回 10~30，落差 20 米，提高垂直密度
+        // 这里的基准高度 raised 到 10.0f 以上，避免刚生成就可能在地面以下
+        float y = randomFloat(10.0f, 30.0f);
+
+        float randomScale = randomFloat(0.5f, 1.5f);
+        s.Data<ParticleAttr::PositionScale>()[i] = glm::vec4(xz.x, y, xz.y, randomScale);
+
+        // [修改] 稍微加快一点下落速度，增加暴雨感
+        s.Data<ParticleAttr::Velocity>()[i] = glm::vec3(0.0f, randomFloat(-30.0f, -45.0f), 0.0f);
+    }
+
+    static void Update(Storage& s, float dt, glm::vec2 cameraPos, const Params& params)
+    {
+        glm::vec4* pos = s.Data<ParticleAttr::PositionScale>();
+        const glm::vec3* vel = s.Data<ParticleAttr::Velocity>();
+        const size_t count = s.Size();
+        const float radius2 = params.nearRadius * params.nearRadius;
+
+        // --- 热循环 ---
+        // "零开销" 指的是和手写版本生成同样的循环：列是 arena 里连续、64 字节对齐的裸数组，
+        // Update 是静态函数，在 ParticleSystem<RainEffect>::Update 里直接内联，没有虚调用、没有逐粒子分发，
+        // 也只碰这个特效声明过的两列。循环里有两个分支 (触地重生、出界翻面)，
+        // 每帧只有极少数粒子走进去，分支预测几乎总是命中；常见路径就是三次乘加和一次距离平方。
+        for (size_t i = 0; i < count; ++i)
+        {
+            // 1. 物理更新 (向量加法)
+            pos[i].x += vel[i].x * dt;
+            pos[i].y += vel[i].y * dt;
+            pos[i].z += vel[i].z * dt;
+
+            // 2. 触地的回到高空，在相机周围的圆盘内重新分布，这样雨会一直跟着玩家走！
+            float dx = pos[i].x - cameraPos.x;
+            float dz = pos[i].z - cameraPos.y;
+            float dist2 = dx * dx + dz * dz;
+            if (pos[i].y < GROUND_HEIGHT)
+            {
+                pos[i].y = 40.0f;
+                glm::vec2 xz = randomInDisk(cameraPos, params.nearRadius);
+                pos[i].x = xz.x;
+                pos[i].z = xz.y;
+            }
+            // 3. 相机走远后落到近景圆柱之外的：保持高度，沿过相机的直线翻到对侧 (前进方向) 重新进入
+            //    出界多少就从对侧边缘往里退多少，落点仍在淡出带内 (Fade 接近 0)，不会在视野中间突然出现
+            else if (dist2 > radius2)
+            {
+                float dist = std::sqrt(dist2);
+                float r = std::max(2.0f * params.nearRadius - dist, params.nearRadius - params.fadeWidth);
+                pos[i].x = cameraPos.x - dx / dist * r;
+                pos[i].z = cameraPos.y - dz / dist * r;
+            }
+        }
+    }
+};
+
+// 雪：位置 + 速度 + 寿命 + 飘动相位四列，寿命上 GPU 用于淡出，相位只在 CPU 上推进
+// GPU 列用 SSBO 取数 (snow.vert 按 gl_InstanceID 读取)，没有远景层，整片雪都在 radius 以内模拟
+struct SnowEffect
+{
+    using Columns = ColumnList<ParticleAttr::PositionScale, ParticleAttr::Velocity, ParticleAttr::Life, ParticleAttr::Phase>;
+    using Storage = ParticleStorage<Columns>;
+    static constexpr ParticleFetch Fetch = ParticleFetch::StorageBuffer;
+
+    struct Params
+    {
+        float radius = 16.0f;          // 模拟半径 (米)
+        float fadeWidth = 4.0f;        // 边缘淡出带宽度，与 snow.vert 的 Fade 一致
+        float swayAmplitude = 0.6f;    // 水平飘动速度 (米/秒)
+        float swayFrequency = 1.3f;    // 飘动相位的角速度 (弧度/秒)
+    };
+
+    // 生在高处，寿命足够大部分雪花落到地面，少数在空中化掉 (最后一秒淡出)
+    static void Respawn(glm::vec4& pos, glm::vec3& vel, float& life, glm::vec2 center, float minY, const Params& params)
+    {
+        glm::vec2 xz = randomInDisk(center, params.radius);
+        pos = glm::vec4(xz.x, randomFloat(minY, 20.0f), xz.y, randomFloat(0.6f, 1.4f));
+        vel = glm::vec3(randomFloat(-0.3f, 0.3f), randomFloat(-1.0f, -2.0f), randomFloat(-0.3f, 0.3f));
+        life = randomFloat(6.0f, 16.0f);
+    }
+
+    static void Spawn(Storage& s, size_t i, const Params& params)
+    {
+        Respawn(s.Data<ParticleAttr::PositionScale>()[i], s.Data<ParticleAttr::Velocity>()[i], s.Data<ParticleAttr::Life>()[i],
+            glm::vec2(0.0f), GROUND_HEIGHT, params);
+        s.Data<ParticleAttr::Phase>()[i] = randomFloat(0.0f, 6.2831853f);
+    }
+
+    static void Update(Storage& s, float dt, glm::vec2 cameraPos, const Params& params)
+    {
+        glm::vec4* pos = s.Data<ParticleAttr::PositionScale>();
+        glm::vec3* vel = s.Data<ParticleAttr::Velocity>();
+        float* life = s.Data<ParticleAttr::Life>();
+        float* phase = s.Data<ParticleAttr::Phase>();
+        const size_t count = s.Size();
+        const float radius2 = params.radius * params.radius;
+
+        // 和雨一样：常见路径是纯算术 (多了一次 sin/cos 飘动)，重生和出界翻面两个分支每帧只有少数粒子进入
+        for (size_t i = 0; i < count; ++i)
+        {
+            phase[i] += params.swayFrequency * dt;
+            life[i] -= dt;
+            pos[i].x += (vel[i].x + std::cos(phase[i]) * params.swayAmplitude) * dt;
+            pos[i].y += vel[i].y * dt;
+            pos[i].z += (vel[i].z + std::sin(phase[i]) * params.swayAmplitude) * dt;
+
+            float dx = pos[i].x - cameraPos.x;
+            float dz = pos[i].z - cameraPos.y;
+            float dist2 = dx * dx + dz * dz;
+            if (pos[i].y < GROUND_HEIGHT || life[i] <= 0.0f)
+            {
+                // 重生在 12 米以上，平视时在画面之外
+                Respawn(pos[i], vel[i], life[i], cameraPos, 12.0f, params);
+            }
+            else if (dist2 > radius2)
+            {
+                // 与雨相同：沿过相机的直线翻到对侧的淡出带里
+                float dist = std::sqrt(dist2);
+                float r = std::max(2.0f * params.radius - dist, params.radius - params.fadeWidth);
+                pos[i].x = cameraPos.x - dx / dist * r;
+                pos[i].z = cameraPos.y - dz / dist * r;
+            }
+        }
+    }
+};
+
+#endif
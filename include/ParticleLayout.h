@@ -0,0 +1,142 @@
+#ifndef PARTICLELAYOUT_H
+#define PARTICLELAYOUT_H
+
+#include <tuple>
+#include <string>
+#include <cstddef>
+#include <type_traits>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "ColumnArena.h"
+
+// --- 编译期粒子布局 ---
+// 特效用 ColumnList<...> 声明自己的属性列，ParticleStorage 据此生成
+// 一列一个连续数组的 SoA 存储。列的查找全部在编译期完成，热循环里拿到的就是裸指针。
+// 所有列都从同一个 ColumnArena 切出：64 字节对齐、补齐到 SIMD 宽度、优先大页。
+
+template<typename... Columns>
+struct ColumnList {};
+
+// 列在类型列表中的下标
+template<typename Column, typename... Columns>
+struct ColumnIndex;
+
+template<typename Column, typename... Rest>
+struct ColumnIndex<Column, Column, Rest...> : std::integral_constant<size_t, 0> {};
+
+template<typename Column, typename First, typename... Rest>
+struct ColumnIndex<Column, First, Rest...> : std::integral_constant<size_t, 1 + ColumnIndex<Column, Rest...>::value> {};
+
+// GPU 列的取数方式 (由特效选择)
+//   InstanceAttrib：每列一个实例 VBO，layout (location = N) in 读取
+//   StorageBuffer： 每列一个 SSBO，顶点着色器按 gl_InstanceID 下标读取 (vertex pulling)
+enum class ParticleFetch { InstanceAttrib, StorageBuffer };
+
+// 列元素类型对应的 GL 顶点属性格式与 GLSL 类型 (目前只有 float 家族)
+// std430Stride 是该类型作为 std430 数组元素时的步长：vec3 会被补齐到 16 字节，和紧凑的 CPU 列对不上
+template<typename T> struct GLAttribFormat;
+template<> struct GLAttribFormat<float>     { static constexpr GLint components = 1; static constexpr const char* glslType = "float"; static constexpr size_t std430Stride = 4; };
+template<> struct GLAttribFormat<glm::vec2> { static constexpr GLint components = 2; static constexpr const char* glslType = "vec2";  static constexpr size_t std430Stride = 8; };
+template<> struct GLAttribFormat<glm::vec3> { static constexpr GLint components = 3; static constexpr const char* glslType = "vec3";  static constexpr size_t std430Stride = 16; };
+template<> struct GLAttribFormat<glm::vec4> { static constexpr GLint components = 4; static constexpr const char* glslType = "vec4";  static constexpr size_t std430Stride = 16; };
+
+template<typename Layout>
+class ParticleStorage;
+
+template<typename... Columns>
+class ParticleStorage<ColumnList<Columns...>>
+{
+public:
+    static constexpr size_t ColumnCount = sizeof...(Columns);
+
+    // 需要上传到 GPU 的列数
+    static constexpr size_t GpuColumnCount = ((Columns::location >= 0 ? 1 : 0) + ... + 0);
+
+    // 列在 GPU 列中的序号 (StorageBuffer 取数时绑定点 = bindingBase + 序号)
+    template<typename Column>
+    static constexpr unsigned int GpuSlot()
+    {
+        constexpr size_t index = ColumnIndex<Column, Columns...>::value;
+        return ((ColumnIndex<Columns, Columns...>::value < index && Columns::location >= 0 ? 1u : 0u) + ... + 0u);
+    }
+
+    // 生成与 GPU 列匹配的 GLSL 声明，由 Shader 插在顶点着色器的 #version / #extension 之后
+    //   InstanceAttrib：layout(location = 2) in vec4 positionScale;
+    //   StorageBuffer： layout(std430, binding = 4) readonly buffer ParticleColumn4 { vec4 positionScale[]; };
+    template<ParticleFetch Fetch>
+    static std::string GlslDeclarations(unsigned int bindingBase)
+    {
+        std::string declarations;
+        (AppendDeclaration<Fetch, Columns>(declarations, bindingBase), ...);
+        return declarations;
+    }
+
+    // 一次性分配全部列 (内容清零)；重复调用会丢弃旧数据
+    bool Allocate(size_t count, const ColumnArena::Options& options = ColumnArena::Options())
+    {
+        this->count = 0;
+        size_t bytes = (ColumnArena::ColumnBytes<typename Columns::type>(count) + ... + 0);
+        if (!arena.Reserve(bytes, options))
+            return false;
+
+        ((std::get<ColumnIndex<Columns, Columns...>::value>(columns) = arena.Allocate<typename Columns::type>(count)), ...);
+        this->count = count;
+        return true;
+    }
+
+    size_t Size() const { return count; }
+
+    // 补齐到 SIMD 宽度后的长度：[Size(), PaddedSize(Column)) 之间是可安全读写的填充
+    template<typename Column>
+    size_t PaddedSize() const { return ColumnArena::PaddedCount(count, sizeof(typename Column::type)); }
+
+    ColumnArena::Stats GetArenaStats() const { return arena.GetStats(); }
+
+    template<typename Column>
+    typename Column::type* Data()
+    {
+        return std::get<ColumnIndex<Column, Columns...>::value>(columns);
+    }
+
+    template<typename Column>
+    const typename Column::type* Data() const
+    {
+        return std::get<ColumnIndex<Column, Columns...>::value>(columns);
+    }
+
+    // 依次对每一列调用 f(ColumnTag{}, 列下标, 列数据指针)
+    template<typename F>
+    void ForEachColumn(F&& f)
+    {
+        (f(Columns{}, ColumnIndex<Columns, Columns...>::value, Data<Columns>()), ...);
+    }
+
+private:
+    template<ParticleFetch Fetch, typename Column>
+    static void AppendDeclaration(std::string& out, unsigned int bindingBase)
+    {
+        using T = typename Column::type;
+        if constexpr (Column::location >= 0)
+        {
+            if constexpr (Fetch == ParticleFetch::StorageBuffer)
+            {
+                // CPU 列直接整列上传，步长必须和 std430 数组一致
+                static_assert(sizeof(T) == GLAttribFormat<T>::std430Stride, "column type is padded in a std430 array (use vec4 instead of vec3)");
+                std::string binding = std::to_string(bindingBase + GpuSlot<Column>());
+                out += "layout(std430, binding = " + binding + ") readonly buffer ParticleColumn" + binding + " { "
+                    + GLAttribFormat<T>::glslType + " " + Column::name + "[]; };\n";
+            }
+            else
+            {
+                out += "layout(location = " + std::to_string(Column::location) + ") in "
+                    + GLAttribFormat<T>::glslType + " " + Column::name + ";\n";
+            }
+        }
+    }
+
+    size_t count = 0;
+    ColumnArena arena;
+    std::tuple<typename Columns::type*...> columns;
+};
+
+#endif
@@ -1,40 +1,65 @@
 #ifndef PARTICLESYSTEM_H
 #define PARTICLESYSTEM_H
 
-#include <vector>
+#include <array>
+#include <string>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
-#include "Shader.h"
+#include "ParticleEffects.h"
+#include "GpuResources.h"
 
+// Effect 决定属性列、GPU 布局 (实例属性或 SSBO) 和更新内核 (见 ParticleEffects.h)
+// 实现放在 ParticleSystem.cpp，并对已知特效做显式实例化
+template<typename Effect>
 class ParticleSystem
 {
 public:
-    ParticleSystem(Shader& shader, unsigned int amount);
+    using Storage = typename Effect::Storage;
+    using Params = typename Effect::Params;
 
-    // ֻҪ delta time  XZ 
+    // StorageBuffer 取数的 GPU 列从这里开始占用 SSBO 绑定点 (0..3 归 LightGrid)
+    static const unsigned int STORAGE_BINDING_BASE = 4;
+
+    ParticleSystem(unsigned int amount, const Params& params);
+
+    // 与 GPU 列匹配的 GLSL 声明，创建粒子 shader 时作为顶点阶段的前置声明传入
+    static std::string GetShaderDeclarations() { return Storage::template GlslDeclarations<Effect::Fetch>(STORAGE_BINDING_BASE); }
+
+    // 只需要传入 delta time 和相机的 XZ 坐标
     void Update(float dt, glm::vec2 cameraPos);
-    void Draw(glm::vec3 cameraPos);
+
+    // 把 GPU 列上传到实例 VBO / SSBO (后者同时绑定到各自的绑定点)；绘制由调用方作为 DrawPacket 提交到 RenderQueue
+    void Upload();
+
+    // 多视图：每个粒子画 views 个实例，绘制时实例数 = GetAmount() * views
+    // 实例属性取数时 divisor = views；SSBO 取数时 shader 自己用 gl_InstanceID / viewCount 算粒子下标
+    void SetViewCount(unsigned int views);
+
+    unsigned int GetVAO() const { return VAO.ID(); }
+    unsigned int GetAmount() const { return amount; }
+    const Params& GetParams() const { return params; }
+    ColumnArena::Stats GetArenaStats() const { return particles.GetArenaStats(); }
 
 private:
-    Shader& shader;
     unsigned int amount;
+    unsigned int viewCount = 1;
+    Params params;   // 每次 Spawn / Update 原样传给 Effect
 
-    unsigned int VAO;
-    unsigned int quadVBO;
-    unsigned int instanceVBO;
-
-    // --- [Ż SoA] ---
-    // Ӵ Particle ṹ壬 GPU Ҫݺ CPU Ҫݳ׷
-    //  CPU  L1 Cache һɰǧݣѹեӲ
+    // GL 对象由句柄持有，析构时自动删除
+    GpuVertexArray VAO;
+    GpuBuffer quadVBO;
 
-    // 1. GPU Ⱦݣxyz = ꣬w = εֵ (ϸС)
-    // ڴ沼ֺ OpenGL Ҫȫһ£Draw ʱֱǿתָύ0 
-    std::vector<glm::vec4> particleRenderData;
+    // 每个 GPU 列一个实例 VBO 或 SSBO (仅 CPU 使用的列为空句柄)
+    std::array<GpuBuffer, Storage::ColumnCount> columnVBO;
 
-    // 2. CPU ݣ Update λ
-    std::vector<glm::vec3> particleVelocities;
+    // --- [核心优化：面向数据设计 SoA] ---
+    // 抛弃庞大的 Particle 结构体，将 GPU 需要的数据和 CPU 需要的数据彻底分离
+    // 这让 CPU 的 L1 Cache 能一次性塞入成百上千个数据，极限压榨硬件性能
+    // 列由 Effect::Columns 在编译期决定，GPU 列的内存布局和 OpenGL 需要的完全一致，
+    // Draw 时直接提交指针，0 拷贝！
+    Storage particles;
 
     void init();
 };
 
-#endif
\ No newline at end of file
+#endif
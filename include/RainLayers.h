@@ -0,0 +1,54 @@
+#ifndef RAINLAYERS_H
+#define RAINLAYERS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "GpuResources.h"
+#include "ParticleEffects.h"
+
+// --- 远景雨幕 (Far-field Rain) ---
+// 近景 (nearRadius 以内) 由 ParticleSystem<RainEffect> 逐滴模拟；
+// 更远处的雨滴在屏幕上不到一个像素，逐滴模拟、上传、混合都是浪费。
+// 这里用几层以相机为中心的同心圆柱面代替：
+//   1. 雨丝纹理只在构造时生成一次 (可平铺)，shader 里按时间纵向滚动
+//   2. 圆柱半径按 layerSpacing 的等比数列排开，越远的层越淡、纹理平铺越密
+//   3. 所有层一次实例化绘制 (gl_InstanceID = 层号)，每帧只有一个 draw call
+// 近景粒子在 [nearRadius - fadeWidth, nearRadius] 内淡出，第一层雨幕正好在 nearRadius 处接上，
+// 交界处没有硬边。nearRadius / fadeWidth 不在 Config 里：构造时取自近景粒子系统的 RainEffect::Params，
+// 两边只有一个来源，不会各改各的。
+class RainLayers
+{
+public:
+    struct Config
+    {
+        float layerSpacing = 1.6f;   // 相邻层的半径比
+        unsigned int layerCount = 4;
+        float height = 30.0f;        // 雨幕高度 (从地面往上)
+    };
+
+    // nearParams 传 ParticleSystem<RainEffect>::GetParams()：第一层半径 = nearParams.nearRadius
+    RainLayers(const RainEffect::Params& nearParams, const Config& config);
+
+    RainLayers(const RainLayers&) = delete;
+    RainLayers& operator=(const RainLayers&) = delete;
+
+    const Config& GetConfig() const { return config; }
+    const RainEffect::Params& GetNearParams() const { return nearParams; }
+    unsigned int GetVAO() const { return VAO.ID(); }
+    unsigned int GetVertexCount() const { return vertexCount; }
+    unsigned int GetTexture() const { return streakTexture.ID(); }
+
+private:
+    RainEffect::Params nearParams;
+    Config config;
+
+    GpuVertexArray VAO;
+    GpuBuffer VBO;
+    unsigned int vertexCount = 0;
+    GpuTexture streakTexture;
+
+    void createCylinder();
+    void createStreakTexture();
+};
+
+#endif
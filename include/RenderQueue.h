@@ -0,0 +1,132 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <initializer_list>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// 每帧渲染统计
+struct RenderStats
+{
+    unsigned int drawCalls = 0;
+    unsigned int stateChanges = 0;    // 实际发出的 program / texture / VAO / uniform 调用
+    unsigned int stateSkipped = 0;    // 被状态缓存拦下的冗余调用
+
+    void Reset() { drawCalls = 0; stateChanges = 0; stateSkipped = 0; }
+};
+
+// 一个 uniform 的值 (按 location 提交，不在热路径上查字符串)
+struct UniformValue
+{
+    enum class Type : uint8_t { Int, Float, Vec3, Mat4 };
+
+    GLint location;
+    Type type;
+    float data[16];
+
+    static UniformValue Int(GLint location, int value);
+    static UniformValue Float(GLint location, float value);
+    static UniformValue Vec3(GLint location, const glm::vec3& value);
+    static UniformValue Mat4(GLint location, const glm::mat4& value);
+
+    size_t FloatCount() const;
+};
+
+// --- GL 状态缓存 ---
+// 记住当前绑定的 program / VAO / 各纹理单元，以及每个 program 里 uniform 的最后取值，
+// 与当前状态相同的调用直接跳过。
+// 队列之外的代码如果改动了这些状态，必须调用 Invalidate()。
+class GLStateCache
+{
+public:
+    static const unsigned int MAX_TEXTURE_UNITS = 16;
+
+    GLStateCache();
+
+    void Invalidate();
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vao);
+    void BindTexture(unsigned int unit, unsigned int texture);
+    void SetUniform(const UniformValue& value);
+
+    // 统计计数 (由 RenderQueue 每帧读取并清零)
+    RenderStats stats;
+
+private:
+    struct CachedUniform
+    {
+        UniformValue::Type type;
+        float data[16];
+    };
+
+    unsigned int program;
+    unsigned int vao;
+    unsigned int activeUnit;
+    unsigned int textures[MAX_TEXTURE_UNITS];   // 只跟踪 GL_TEXTURE_2D
+
+    // key = (program << 32) | location
+    std::unordered_map<uint64_t, CachedUniform> uniforms;
+};
+
+// 一次绘制需要的全部状态
+struct DrawPacket
+{
+    static const unsigned int MAX_TEXTURES = 8;
+
+    unsigned int program = 0;
+    unsigned int vao = 0;
+    unsigned int textures[MAX_TEXTURES] = {};   // 第 i 个纹理绑到第 i 个纹理单元
+    unsigned int textureCount = 0;
+
+    GLenum mode = GL_TRIANGLES;
+    GLint first = 0;
+    GLsizei count = 0;
+    GLsizei instanceCount = 1;
+
+    // 在队列 uniform 数组中的区间 (Submit 时填写)
+    uint32_t uniformOffset = 0;
+    uint32_t uniformCount = 0;
+};
+
+// --- 排序渲染队列 ---
+// 各 pass 提交带 64 位排序键的 DrawPacket，Execute 时先排序再经过状态缓存执行，
+// 提交开销随"不同状态的数量"增长，而不是随 draw 数量增长。
+//
+// 排序键布局 (高位优先):
+//   不透明:  [63..60 pass][59..48 program][47..32 material][31..8 depth 由近到远][7..0 保留]
+//   半透明:  [63..60 pass][59..36 depth 由远到近][35..24 program][23..8 material][7..0 保留]
+class RenderQueue
+{
+public:
+    enum Pass : unsigned int { PASS_OPAQUE = 0, PASS_TRANSPARENT = 1, PASS_COUNT };
+
+    explicit RenderQueue(GLStateCache& cache);
+
+    // depth 取 [0, 1] (例如 视距 / 远平面)
+    static uint64_t MakeKey(Pass pass, unsigned int program, unsigned int material, float depth);
+
+    void Submit(uint64_t key, const DrawPacket& packet, std::initializer_list<UniformValue> uniforms = {});
+
+    // 排序、执行并清空队列，返回本帧统计
+    // onPassBegin 在每个 pass 的第一个 packet 之前调用 (用于 GPU 计时等)
+    RenderStats Execute(const std::function<void(Pass)>& onPassBegin = nullptr);
+
+private:
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    GLStateCache& cache;
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> order;
+    std::vector<UniformValue> uniformData;
+};
+
+#endif
@@ -1,38 +1,44 @@
 #ifndef SHADER_H
 #define SHADER_H
 
-// Include Guard (ʽ)
+// Include Guard (防卫式声明)
 // #ifndef ... #define ... #endif
-// ֹͷļദʱظ壬±
+// 防止头文件被多处引用时重复定义，导致编译错误。
 
-#include <glad/glad.h> //  GLAD  OpenGL 
+#include <glad/glad.h> // 必须包含 GLAD 才能用 OpenGL 类型
 #include <glm/glm.hpp>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <unordered_map>
 #include <iostream>
 
 class Shader
 {
 public:
-    //  ID (Program ID)
-    // Windows  "" (Handle)  Linux  "ļ" (fd)
-    //  ID ָ GPU һɫ
+    // 程序 ID (Program ID)
+    // 类似于Windows 里的 "句柄" (Handle) 或者 Linux 的 "文件描述符" (fd)
+    // 拿着这个 ID 就能指挥 GPU 里的这一套着色器程序。
     unsigned int ID;
 
-    // 캯
-    // ļ·Զȡ롢
+    // 构造函数
+    // 传入两个资源路径，它会通过 VirtualFileSystem 读取，然后编译、链接
     Shader(const char* vertexPath, const char* fragmentPath);
 
-    // ʱԶ GPU Դ
+    // 带细分控制 / 细分求值阶段的版本
+    Shader(const char* vertexPath, const char* tessControlPath, const char* tessEvalPath, const char* fragmentPath);
+
+    // 顶点阶段带一段生成的声明 (粒子列的实例属性 / SSBO，见 ParticleLayout.h)
+    // 插在源码开头的 #version / #extension 行之后，其余行号用 #line 保持不变
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& vertexDeclarations);
+
+    // 析构函数，对象销毁时自动清理 GPU 资源
     ~Shader();
 
-    // 
-    // װ glUseProgram(ID)
+    // 激活程序
+    // 封装了 glUseProgram(ID)
     void use();
 
-    // Uniform ߺ (õԤ)
-    //  CPU ̬ı GPU ııɫȣ
+    // Uniform 工具函数 (后续会用到，先预留)
+    // 用于 CPU 动态改变 GPU 里的变量（比如改变颜色、亮度）
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
     void setFloat(const std::string& name, float value) const;
@@ -42,10 +48,23 @@ public:
 
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // 查询 uniform location，结果按名字缓存
+    // 热路径 (RenderQueue) 应在初始化时查好 location，之后只按 location 提交
+    int getUniformLocation(const std::string& name) const;
+
 private:
-    // ˽кڼ/Ƿ
-    // һܺõķװϰߣڲۻҪ¶ⲿ
+    // 私有函数：用于检查编译/链接是否出错
+    // 这是一个很好的封装习惯：内部脏活累活不要暴露给外部
     void checkCompileErrors(unsigned int shader, std::string type);
+
+    // 编译各阶段并链接 (构造函数共用)
+    void build(const char* vertexPath, const char* tessControlPath, const char* tessEvalPath, const char* fragmentPath,
+        const std::string& vertexDeclarations);
+
+    // 从 VirtualFileSystem 读取并编译一个阶段，返回 shader 对象；declarations 非空时插在文件头之后
+    unsigned int compileStage(GLenum type, const char* path, const char* typeName, const std::string& declarations = std::string());
+
+    mutable std::unordered_map<std::string, int> uniformLocations;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef VIRTUALFILESYSTEM_H
+#define VIRTUALFILESYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetArchive.h"
+
+// 一段只读的资源数据 (指向 mmap 的资源包或松散文件缓存，不拥有内存)
+// 在 VirtualFileSystem 卸载之前一直有效
+struct AssetView
+{
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+    // 文本资源 (shader 源码) 直接以 string_view 访问，注意它不以 '\0' 结尾
+    std::string_view Text() const { return std::string_view(reinterpret_cast<const char*>(data), size); }
+};
+
+// --- 虚拟文件系统 ---
+// 启动时把 assets.pak 整个 mmap 进来，之后按路径查索引，返回指向映射内存的视图：
+//   1. 冷启动只打开一个文件 (网络盘上每次 open/stat 都是一次往返)
+//   2. shader 源码、纹理压缩数据直接从映射内存交给 GL / 解码器，中间不经过 string 拷贝
+//   3. 条目内容哈希在第一次访问时校验，不访问的资源不会被读入
+// 资源包不存在时退回到读松散文件 (开发时改 shader 不用重新打包)。
+class VirtualFileSystem
+{
+public:
+    struct Stats
+    {
+        size_t archiveBytes = 0;
+        unsigned int archiveEntries = 0;
+        unsigned int archiveHits = 0;
+        unsigned int looseReads = 0;
+        unsigned int hashFailures = 0;
+    };
+
+    static VirtualFileSystem& Get();
+
+    ~VirtualFileSystem();
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    // 映射资源包；失败时返回 false，之后的 Open 全部走松散文件
+    bool Mount(const char* archivePath);
+    void Unmount();
+    bool IsMounted() const { return base != nullptr; }
+
+    // path 与松散文件的相对路径一致，如 "assets/shaders/ground.frag"；找不到返回空视图
+    AssetView Open(const std::string& path);
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    VirtualFileSystem() = default;
+
+    const AssetArchive::Entry* findEntry(const std::string& path) const;
+    AssetView readLoose(const std::string& path);
+
+    const unsigned char* base = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    const AssetArchive::Header* header = nullptr;
+    const AssetArchive::Entry* entries = nullptr;
+    std::vector<uint8_t> verified;   // 每个条目：0 未校验 / 1 通过 / 2 失败
+
+    // 松散文件退路：读过一次就留在内存里，返回的视图同样保持有效
+    std::unordered_map<std::string, std::vector<unsigned char>> looseFiles;
+
+    Stats stats;
+};
+
+#endif
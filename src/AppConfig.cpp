@@ -0,0 +1,39 @@
+#include "AppConfig.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+AppConfig AppConfig::FromArgs(int argc, char** argv)
+{
+    AppConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--views") == 0 && i + 1 < argc)
+            config.views = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            config.targetFps = static_cast<float>(std::max(0.0, std::atof(argv[++i])));
+        else if (std::strcmp(argv[i], "--gpu-budget") == 0 && i + 1 < argc)
+            config.gpuBudgetMB = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--weather") == 0 && i + 1 < argc)
+            config.weather = std::strcmp(argv[++i], "snow") == 0 ? Weather::Snow : Weather::Rain;
+        else if (std::strcmp(argv[i], "--bench") == 0)
+            config.bench = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            config.frames = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            config.warmupFrames = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--keyframes") == 0 && i + 1 < argc)
+            config.keyFrameCount = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            unsigned int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%ux%u", &w, &h) == 2 && w > 0 && h > 0)
+            {
+                config.width = w;
+                config.height = h;
+            }
+        }
+    }
+    return config;
+}
@@ -0,0 +1,400 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+#include <GLFW/glfw3.h>
+
+#ifdef KINETIC_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// ---------------------------------------------------------
+// HeadlessContext
+// ---------------------------------------------------------
+
+#ifdef KINETIC_HAS_EGL
+// EGL_MESA_platform_surfaceless：不需要任何窗口系统，渲染全部进 FBO
+static bool createSurfacelessContext(EGLDisplay& outDisplay, EGLContext& outContext)
+{
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay)
+        return false;
+
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+        return false;
+
+    // surfaceless 平台通常不导出任何 EGLConfig，此时用 EGL_KHR_no_config_context
+    const EGLint configAttribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) || numConfigs == 0)
+        config = EGL_NO_CONFIG_KHR;
+
+    // 软件光栅 (llvmpipe) 目前只到 4.5 core，shader 也按 450 编写
+    EGLContext context = EGL_NO_CONTEXT;
+    if (eglBindAPI(EGL_OPENGL_API))
+    {
+        for (EGLint minor = 6; minor >= 5 && context == EGL_NO_CONTEXT; --minor)
+        {
+            const EGLint contextAttribs[] = {
+                EGL_CONTEXT_MAJOR_VERSION, 4,
+                EGL_CONTEXT_MINOR_VERSION, minor,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+            };
+            context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+        }
+    }
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        if (context != EGL_NO_CONTEXT)
+            eglDestroyContext(display, context);
+        eglTerminate(display);
+        return false;
+    }
+
+    outDisplay = display;
+    outContext = context;
+    return true;
+}
+#endif
+
+std::unique_ptr<HeadlessContext> HeadlessContext::Create(const AppConfig& config)
+{
+    std::unique_ptr<HeadlessContext> ctx(new HeadlessContext());
+
+#ifdef KINETIC_HAS_EGL
+    EGLDisplay display;
+    EGLContext context;
+    if (createSurfacelessContext(display, context))
+    {
+        ctx->eglDisplay = display;
+        ctx->eglContext = context;
+        return ctx;
+    }
+    std::cout << "[bench] EGL surfaceless context unavailable, falling back to GLFW" << std::endl;
+#endif
+
+    // 构建机上没有人看窗口，把 GLFW 的错误原因直接打出来方便排查
+    glfwSetErrorCallback([](int code, const char* description) {
+        std::cout << "[bench] GLFW error 0x" << std::hex << code << std::dec << ": " << description << std::endl;
+    });
+
+    const int platforms[] = { GLFW_PLATFORM_NULL, GLFW_ANY_PLATFORM };
+    const int contextApis[] = { GLFW_OSMESA_CONTEXT_API, GLFW_NATIVE_CONTEXT_API };
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        glfwInitHint(GLFW_PLATFORM, platforms[attempt]);
+        if (!glfwInit())
+            continue;
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApis[attempt]);
+
+        // 实际渲染目标是 FBO，窗口本身只是上下文的载体
+        ctx->window = glfwCreateWindow(config.width, config.height, "KineticCore - Bench", NULL, NULL);
+        if (ctx->window)
+        {
+            glfwMakeContextCurrent(ctx->window);
+            return ctx;
+        }
+        glfwTerminate();
+    }
+    return nullptr;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+#ifdef KINETIC_HAS_EGL
+    if (eglDisplay)
+    {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+    }
+#endif
+    if (window)
+        glfwTerminate();
+}
+
+GLADloadproc HeadlessContext::Loader() const
+{
+#ifdef KINETIC_HAS_EGL
+    if (eglDisplay)
+        return (GLADloadproc)eglGetProcAddress;
+#endif
+    return (GLADloadproc)glfwGetProcAddress;
+}
+
+// ---------------------------------------------------------
+// CameraPath
+// ---------------------------------------------------------
+
+CameraPath::CameraPath(std::vector<Keyframe> keys)
+    : keys(std::move(keys))
+{
+}
+
+CameraPath CameraPath::Default()
+{
+    // 路灯在 (0, 5, -4)，路径覆盖近景水洼、侧面掠射和高处俯视三种典型画面
+    return CameraPath({
+        { glm::vec3( 0.0f, 1.6f,  2.7f),  -90.0f, -30.0f },
+        { glm::vec3( 3.0f, 1.2f,  0.0f), -135.0f, -20.0f },
+        { glm::vec3( 4.0f, 1.8f, -6.0f), -200.0f, -25.0f },
+        { glm::vec3(-4.0f, 2.5f, -7.0f),  -20.0f, -30.0f },
+        { glm::vec3( 0.0f, 8.0f,  6.0f),  -90.0f, -50.0f },
+    });
+}
+
+void CameraPath::Apply(Camera& camera, float t) const
+{
+    if (keys.empty())
+        return;
+
+    t = glm::clamp(t, 0.0f, 1.0f);
+    float scaled = t * static_cast<float>(keys.size() - 1);
+    size_t index = std::min(static_cast<size_t>(scaled), keys.size() - 1);
+    size_t next = std::min(index + 1, keys.size() - 1);
+
+    // smoothstep 让每段首尾速度为 0，避免关键帧处的突变
+    float f = scaled - static_cast<float>(index);
+    f = f * f * (3.0f - 2.0f * f);
+
+    const Keyframe& a = keys[index];
+    const Keyframe& b = keys[next];
+    camera.Position = glm::mix(a.position, b.position, f);
+    camera.SetOrientation(glm::mix(a.yaw, b.yaw, f), glm::mix(a.pitch, b.pitch, f));
+}
+
+// ---------------------------------------------------------
+// GpuPassTimer
+// ---------------------------------------------------------
+
+GpuPassTimer::GpuPassTimer(unsigned int passCount)
+    : queries(passCount)
+{
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+}
+
+GpuPassTimer::~GpuPassTimer()
+{
+    glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+}
+
+void GpuPassTimer::Begin(unsigned int pass)
+{
+    glBeginQuery(GL_TIME_ELAPSED, queries[pass]);
+}
+
+void GpuPassTimer::End()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+void GpuPassTimer::Collect(std::vector<float>& passMs)
+{
+    passMs.resize(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+        passMs[i] = static_cast<float>(ns) / 1.0e6f;
+    }
+}
+
+// ---------------------------------------------------------
+// OffscreenTarget
+// ---------------------------------------------------------
+
+OffscreenTarget::OffscreenTarget(unsigned int width, unsigned int height)
+    : width(width), height(height)
+{
+    glGenFramebuffers(1, &this->FBO);
+    this->colorRBO = GpuRenderbuffer("bench color target");
+    this->colorRBO.Storage(GL_RGBA8, width, height);
+    this->depthRBO = GpuRenderbuffer("bench depth target");
+    this->depthRBO.Storage(GL_DEPTH_COMPONENT24, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->colorRBO.ID());
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, this->depthRBO.ID());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Offscreen target is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    glDeleteFramebuffers(1, &this->FBO);
+}
+
+void OffscreenTarget::Bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+    glViewport(0, 0, width, height);
+}
+
+void OffscreenTarget::ReadPixels(std::vector<unsigned char>& pixels)
+{
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, this->FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+// ---------------------------------------------------------
+// PerceptualHash
+// ---------------------------------------------------------
+
+uint64_t PerceptualHash(const std::vector<unsigned char>& rgba, unsigned int width, unsigned int height)
+{
+    // 1. 盒式滤波缩小到 9x8 灰度
+    const unsigned int GW = 9, GH = 8;
+    float gray[GH][GW] = {};
+    for (unsigned int gy = 0; gy < GH; ++gy)
+    {
+        unsigned int y0 = gy * height / GH, y1 = std::max(y0 + 1, (gy + 1) * height / GH);
+        for (unsigned int gx = 0; gx < GW; ++gx)
+        {
+            unsigned int x0 = gx * width / GW, x1 = std::max(x0 + 1, (gx + 1) * width / GW);
+            float sum = 0.0f;
+            for (unsigned int y = y0; y < y1; ++y)
+            {
+                const unsigned char* row = &rgba[(static_cast<size_t>(y) * width) * 4];
+                for (unsigned int x = x0; x < x1; ++x)
+                    sum += 0.299f * row[x * 4 + 0] + 0.587f * row[x * 4 + 1] + 0.114f * row[x * 4 + 2];
+            }
+            gray[gy][gx] = sum / static_cast<float>((y1 - y0) * (x1 - x0));
+        }
+    }
+
+    // 2. 每行 8 个比较位，共 64 位
+    uint64_t hash = 0;
+    for (unsigned int gy = 0; gy < GH; ++gy)
+        for (unsigned int gx = 0; gx < GW - 1; ++gx)
+            hash = (hash << 1) | (gray[gy][gx] < gray[gy][gx + 1] ? 1u : 0u);
+    return hash;
+}
+
+// ---------------------------------------------------------
+// BenchReport
+// ---------------------------------------------------------
+
+BenchReport::BenchReport(std::vector<std::string> passNames)
+    : passNames(std::move(passNames)), passSamples(this->passNames.size())
+{
+}
+
+// Mesa / Google 的软件光栅器：GL_RENDERER 里带这些名字
+static bool isSoftwareRenderer(const std::string& renderer)
+{
+    const char* names[] = { "llvmpipe", "softpipe", "SwiftShader", "Software Rasterizer", "swrast" };
+    for (const char* name : names)
+        if (renderer.find(name) != std::string::npos)
+            return true;
+    return false;
+}
+
+void BenchReport::SetRenderer(const std::string& renderer, size_t queryPassCount)
+{
+    this->renderer = renderer;
+    this->softwareRenderer = isSoftwareRenderer(renderer);
+    this->queryPassCount = std::min(queryPassCount, passNames.size());
+}
+
+void BenchReport::AddFrame(float frameMs, const std::vector<float>& passMs, const RenderStats& stats)
+{
+    frameSamples.push_back(frameMs);
+    for (size_t i = 0; i < passSamples.size() && i < passMs.size(); ++i)
+        passSamples[i].push_back(passMs[i]);
+    statSamples.push_back(stats);
+}
+
+void BenchReport::AddKeyFrame(unsigned int frame, uint64_t hash)
+{
+    keyFrames.emplace_back(frame, hash);
+}
+
+void BenchReport::AddArenaStats(const std::string& name, const ColumnArena::Stats& stats)
+{
+    arenas.emplace_back(name, stats);
+}
+
+// 打印一行分布：排序后取百分位
+static void printDistribution(const std::string& name, std::vector<float> samples)
+{
+    if (samples.empty())
+        return;
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](float p) { return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))]; };
+    float mean = 0.0f;
+    for (float s : samples) mean += s;
+    mean /= static_cast<float>(samples.size());
+
+    std::printf("  %-12s mean %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n",
+        name.c_str(), mean, pct(0.50f), pct(0.95f), pct(0.99f), samples.back());
+}
+
+void BenchReport::Print() const
+{
+    std::printf("[bench] %zu frames  renderer: %s%s\n", frameSamples.size(),
+        renderer.empty() ? "unknown" : renderer.c_str(), softwareRenderer ? " (software rasterizer)" : "");
+    printDistribution("frame", frameSamples);
+    for (size_t i = 0; i < passNames.size(); ++i)
+    {
+        if (i == 0 && queryPassCount > 0)
+        {
+            if (softwareRenderer)
+                std::printf("  -- pass time (GL_TIME_ELAPSED on a software rasterizer: CPU raster time, not GPU time) --\n");
+            else
+                std::printf("  -- GPU pass time (GL_TIME_ELAPSED) --\n");
+        }
+        if (i == queryPassCount && i > 0)
+            std::printf("  -- CPU time --\n");
+        printDistribution(passNames[i], passSamples[i]);
+    }
+
+    if (!statSamples.empty())
+    {
+        unsigned long long draws = 0, states = 0, skipped = 0;
+        for (const RenderStats& s : statSamples)
+        {
+            draws += s.drawCalls;
+            states += s.stateChanges;
+            skipped += s.stateSkipped;
+        }
+        double n = static_cast<double>(statSamples.size());
+        std::printf("  draws/frame %.1f  state changes/frame %.1f  redundant skipped/frame %.1f\n",
+            draws / n, states / n, skipped / n);
+    }
+
+    for (const auto& key : keyFrames)
+        std::printf("  keyframe %5u  dhash %016llx\n", key.first, static_cast<unsigned long long>(key.second));
+
+    for (const auto& arena : arenas)
+    {
+        const ColumnArena::Stats& s = arena.second;
+        std::printf("  arena %-10s reserved %.2f MB  used %.2f MB  padding %zu B  columns %zu  pages: %s\n",
+            arena.first.c_str(), s.reservedBytes / 1048576.0, s.usedBytes / 1048576.0, s.paddingBytes,
+            s.allocations, ToString(s.hugePages));
+        if (!s.chunksPerNode.empty())
+        {
+            std::printf("  arena %-10s chunks per NUMA node:", arena.first.c_str());
+            for (size_t node = 0; node < s.chunksPerNode.size(); ++node)
+                std::printf(" n%zu=%zu", node, s.chunksPerNode[node]);
+            std::printf("\n");
+        }
+    }
+}
@@ -15,10 +15,10 @@ Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
 
 glm::mat4 Camera::GetViewMatrix()
 {
-    // GLM  LookAt ͼѧĺ
-    // 1: λ
-    // 2: Ŀλ (ǰλ + ߷)
-    // 3: 
+    // GLM 的 LookAt 是图形学核心函数：
+    // 参数1: 相机位置
+    // 参数2: 目标位置 (当前位置 + 视线方向)
+    // 参数3: 上向量
     return glm::lookAt(Position, Position + Front, Up);
 }
 
@@ -47,7 +47,7 @@ void Camera::ProcessMouseMovement(float xoffset, float yoffset, GLboolean constr
     Yaw += xoffset;
     Pitch += yoffset;
 
-    //  Pitchֹ (Gimbal Lock)  ת
+    // 限制 Pitch，防止出现万向节死锁 (Gimbal Lock) 或 翻转
     if (constrainPitch)
     {
         if (Pitch > 89.0f)
@@ -68,17 +68,24 @@ void Camera::ProcessMouseScroll(float yoffset)
         Zoom = 45.0f;
 }
 
+void Camera::SetOrientation(float yaw, float pitch)
+{
+    Yaw = yaw;
+    Pitch = pitch;
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
-    // µ Front  (ѧ)
+    // 计算新的 Front 向量 (核心数学部分)
     glm::vec3 front;
     front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
     front.y = sin(glm::radians(Pitch));
     front.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
     Front = glm::normalize(front);
      
-    // ¼ Right  Up 
-    // Normalize Ϊ˽Ȳһ 1׼ƶٶȻ/
+    // 重新计算 Right 和 Up 向量
+    // Normalize 是因为叉乘结果长度不一定是 1，必须标准化，否则移动速度会变慢/快
     Right = glm::normalize(glm::cross(Front, WorldUp));
     Up = glm::normalize(glm::cross(Right, Front));
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "ColumnArena.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+// numaif.h 不一定安装，这两个标志直接取内核的定义
+#ifndef MPOL_F_NODE
+#define MPOL_F_NODE (1 << 0)
+#endif
+#ifndef MPOL_F_ADDR
+#define MPOL_F_ADDR (1 << 1)
+#endif
+#endif
+
+const char* ToString(ColumnArena::HugePages mode)
+{
+    switch (mode)
+    {
+    case ColumnArena::HugePages::Explicit:    return "explicit (MAP_HUGETLB)";
+    case ColumnArena::HugePages::Transparent: return "transparent (madvise)";
+    default:                                  return "none";
+    }
+}
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+ColumnArena::~ColumnArena()
+{
+    Release();
+}
+
+size_t ColumnArena::PaddedCount(size_t count, size_t elementSize)
+{
+    // 找到最小的元素个数 n，使 n * elementSize 是 SIMD_BYTES 的整数倍
+    size_t lanes = 1;
+    while ((lanes * elementSize) % SIMD_BYTES != 0)
+        ++lanes;
+    return alignUp(std::max<size_t>(count, 1), lanes);
+}
+
+bool ColumnArena::Reserve(size_t bytes, const Options& options)
+{
+    Release();
+    bytes = alignUp(std::max<size_t>(bytes, ALIGNMENT), HUGE_PAGE_SIZE);
+
+#ifdef _WIN32
+    // Windows 大页需要 SeLockMemoryPrivilege，这里只保证对齐 (页对齐天然满足 64 字节)
+    base = static_cast<unsigned char*>(VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    if (!base)
+        return false;
+    stats.hugePages = HugePages::None;
+#else
+    void* p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // 1. 显式大页：需要系统预留 (vm.nr_hugepages)，池子不够时 mmap 直接失败
+    if (options.hugePages == HugePages::Explicit)
+    {
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+            stats.hugePages = HugePages::Explicit;
+    }
+#endif
+
+    if (p == MAP_FAILED)
+    {
+        // 2. 普通映射，多映射 2MB 再裁掉首尾，保证起始地址按大页对齐，透明大页才能整页合并
+        size_t mapBytes = bytes + HUGE_PAGE_SIZE;
+        void* raw = mmap(NULL, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return false;
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = alignUp(start, HUGE_PAGE_SIZE);
+        if (aligned > start)
+            munmap(raw, aligned - start);
+        size_t tail = (start + mapBytes) - (aligned + bytes);
+        if (tail > 0)
+            munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+        p = reinterpret_cast<void*>(aligned);
+
+        stats.hugePages = HugePages::None;
+#ifdef MADV_HUGEPAGE
+        if (options.hugePages != HugePages::None && madvise(p, bytes, MADV_HUGEPAGE) == 0)
+            stats.hugePages = HugePages::Transparent;
+#endif
+    }
+
+    base = static_cast<unsigned char*>(p);
+#endif
+
+    capacity = bytes;
+    offset = 0;
+    stats.reservedBytes = bytes;
+
+    // 3. first touch：整块清零
+    //    mmap 出来的页在第一次写之前没有物理内存，谁先写就分配在谁的 NUMA 节点上；
+    //    Reserve 在创建粒子系统的线程上调用，之后的 Update 也在这个线程上跑，页就落在它的节点上
+    std::memset(base, 0, capacity);
+    chunkSize = alignUp(std::max<size_t>(options.chunkBytes, ALIGNMENT), ALIGNMENT);
+    return true;
+}
+
+void* ColumnArena::AllocateBytes(size_t bytes, size_t requestedBytes)
+{
+    size_t start = alignUp(offset, ALIGNMENT);
+    if (!base || start + bytes > capacity)
+        return nullptr;
+
+    stats.paddingBytes += (start - offset) + (bytes - requestedBytes);
+    stats.usedBytes = start + bytes;
+    stats.allocations++;
+    offset = start + bytes;
+    return base + start;
+}
+
+ColumnArena::Stats ColumnArena::GetStats() const
+{
+    Stats result = stats;
+
+#ifdef __linux__
+    // 每块取首页所在的 NUMA 节点 (get_mempolicy + MPOL_F_ADDR)，容器里没有权限时直接留空
+    for (size_t off = 0; base && off < offset; off += chunkSize)
+    {
+        int node = -1;
+        if (syscall(SYS_get_mempolicy, &node, NULL, 0, base + off, MPOL_F_NODE | MPOL_F_ADDR) != 0 || node < 0)
+        {
+            result.chunksPerNode.clear();
+            break;
+        }
+        if (static_cast<size_t>(node) >= result.chunksPerNode.size())
+            result.chunksPerNode.resize(node + 1, 0);
+        result.chunksPerNode[node]++;
+    }
+#endif
+    return result;
+}
+
+void ColumnArena::Release()
+{
+    if (base)
+    {
+#ifdef _WIN32
+        VirtualFree(base, 0, MEM_RELEASE);
+#else
+        munmap(base, capacity);
+#endif
+    }
+    base = nullptr;
+    capacity = 0;
+    offset = 0;
+    stats = Stats();
+}
@@ -0,0 +1,136 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer(const Config& config)
+    : config(config)
+{
+    this->config.maxFramesInFlight = std::max(this->config.maxFramesInFlight, 1u);
+}
+
+FramePacer::~FramePacer()
+{
+    for (GLsync fence : inFlight)
+        glDeleteSync(fence);
+}
+
+void FramePacer::BeginFrame()
+{
+    // --- 1. 队列深度：等最老的一帧执行完，腾出位置给本帧 ---
+    while (inFlight.size() >= config.maxFramesInFlight)
+    {
+        GLsync fence = inFlight.front();
+        inFlight.pop_front();
+
+        auto waitStart = Clock::now();
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            // 第一次等待带上 FLUSH，保证 fence 本身已经送到 GPU
+            ++fenceWaits;
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            do
+            {
+                result = glClientWaitSync(fence, flags, 1000000);   // 1ms 一轮
+                flags = 0;
+            } while (result == GL_TIMEOUT_EXPIRED);
+            fenceWaitMs += std::chrono::duration<float, std::milli>(Clock::now() - waitStart).count();
+        }
+        glDeleteSync(fence);
+    }
+
+    // --- 2. 目标帧率 ---
+    Clock::time_point now = Clock::now();
+    if (config.targetFps > 0.0f)
+    {
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / config.targetFps));
+        if (!started)
+        {
+            deadline = now;
+        }
+        else
+        {
+            deadline += period;
+            // 落后超过一整帧就不追了，从现在重新计时，避免连续几帧不等待的突发
+            if (now > deadline + period)
+                deadline = now;
+            waitUntil(deadline);
+            now = Clock::now();
+        }
+    }
+
+    // --- 3. 帧间隔 ---
+    if (started)
+        addSample(intervalSamples, intervalCursor, std::chrono::duration<float, std::milli>(now - lastFrameStart).count());
+    lastFrameStart = now;
+    started = true;
+    hasInput = false;
+}
+
+void FramePacer::MarkInput()
+{
+    inputTime = Clock::now();
+    hasInput = true;
+}
+
+void FramePacer::EndFrame()
+{
+    // 提交完成的时刻：之后只剩交换缓冲
+    if (hasInput)
+        addSample(latencySamples, latencyCursor, std::chrono::duration<float, std::milli>(Clock::now() - inputTime).count());
+
+    inFlight.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    ++frames;
+}
+
+void FramePacer::waitUntil(Clock::time_point target) const
+{
+    auto margin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(config.spinMarginMs));
+    Clock::time_point now = Clock::now();
+    if (target - now > margin)
+        std::this_thread::sleep_for(target - now - margin);
+    while (Clock::now() < target)
+        std::this_thread::yield();
+}
+
+void FramePacer::addSample(std::vector<float>& samples, size_t& cursor, float value)
+{
+    if (samples.size() < SAMPLE_WINDOW)
+    {
+        samples.push_back(value);
+        return;
+    }
+    samples[cursor] = value;
+    cursor = (cursor + 1) % SAMPLE_WINDOW;
+}
+
+FramePacer::Stats FramePacer::GetStats() const
+{
+    Stats stats;
+    stats.frames = frames;
+    stats.fenceWaits = fenceWaits;
+    stats.fenceWaitMs = fenceWaitMs;
+
+    auto summarize = [](std::vector<float> samples, float& mean, float& p99, float* max) {
+        if (samples.empty())
+            return;
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (float s : samples) sum += s;
+        mean = static_cast<float>(sum / samples.size());
+        p99 = samples[std::min(samples.size() - 1, static_cast<size_t>(0.99f * samples.size()))];
+        if (max) *max = samples.back();
+    };
+    summarize(latencySamples, stats.latencyMeanMs, stats.latencyP99Ms, &stats.latencyMaxMs);
+    summarize(intervalSamples, stats.intervalMeanMs, stats.intervalP99Ms, nullptr);
+
+    if (!intervalSamples.empty())
+    {
+        double variance = 0.0;
+        for (float s : intervalSamples)
+            variance += (s - stats.intervalMeanMs) * (s - stats.intervalMeanMs);
+        stats.jitterMs = static_cast<float>(std::sqrt(variance / intervalSamples.size()));
+    }
+    return stats;
+}
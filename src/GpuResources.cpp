@@ -0,0 +1,334 @@
+#include "GpuResources.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static const char* kindName(GpuResourceKind kind)
+{
+    switch (kind)
+    {
+    case GpuResourceKind::Buffer: return "buffer";
+    case GpuResourceKind::Texture: return "texture";
+    case GpuResourceKind::Renderbuffer: return "renderbuffer";
+    case GpuResourceKind::VertexArray: return "vertex array";
+    }
+    return "?";
+}
+
+// 按内部格式估算每像素字节数 (这个项目里只有 8 位无压缩格式，其余给个保守值)
+static size_t bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_RED: case GL_R8: return 1;
+    case GL_RG: case GL_RG8: return 2;
+    case GL_RGB: case GL_RGB8: return 3;
+    case GL_RGBA: case GL_RGBA8: return 4;
+    case GL_R16F: return 2;
+    case GL_RGBA16F: return 8;
+    case GL_R32F: return 4;
+    case GL_RGBA32F: return 16;
+    case GL_DEPTH_COMPONENT16: return 2;
+    case GL_DEPTH_COMPONENT24: case GL_DEPTH24_STENCIL8: return 4;   // 24 位深度按 4 字节对齐存放
+    case GL_DEPTH_COMPONENT32F: return 4;
+    default: return 4;
+    }
+}
+
+GpuRegistry& GpuRegistry::Get()
+{
+    static GpuRegistry instance;
+    return instance;
+}
+
+void GpuRegistry::Register(GpuResourceKind kind, unsigned int id, const std::string& owner, GpuResidency residency)
+{
+    if (id == 0)
+        return;
+
+    Entry& entry = entries[makeKey(kind, id)];
+    entry.kind = kind;
+    entry.id = id;
+    entry.owner = owner;
+    entry.residency = residency;
+
+    if (kind == GpuResourceKind::Buffer) totals.buffers++;
+    else if (kind == GpuResourceKind::Texture) totals.textures++;
+    else if (kind == GpuResourceKind::Renderbuffer) totals.renderbuffers++;
+    else totals.vertexArrays++;
+}
+
+void GpuRegistry::Unregister(GpuResourceKind kind, unsigned int id)
+{
+    auto it = entries.find(makeKey(kind, id));
+    if (it == entries.end())
+        return;
+
+    setBytes(it->second, 0);
+    if (kind == GpuResourceKind::Buffer) totals.buffers--;
+    else if (kind == GpuResourceKind::Texture) totals.textures--;
+    else if (kind == GpuResourceKind::Renderbuffer) totals.renderbuffers--;
+    else totals.vertexArrays--;
+    entries.erase(it);
+}
+
+void GpuRegistry::setBytes(Entry& entry, size_t bytes)
+{
+    size_t& total = entry.kind == GpuResourceKind::Buffer ? totals.bufferBytes : totals.textureBytes;
+    total = total - entry.bytes + bytes;
+    entry.bytes = bytes;
+    totals.peakBytes = std::max(totals.peakBytes, totals.Bytes());
+}
+
+void GpuRegistry::SetBufferSize(unsigned int id, size_t bytes, GLenum format)
+{
+    auto it = entries.find(makeKey(GpuResourceKind::Buffer, id));
+    if (it == entries.end())
+        return;
+    it->second.format = format;
+    setBytes(it->second, bytes);
+}
+
+void GpuRegistry::RefreshTexture(unsigned int id)
+{
+    auto it = entries.find(makeKey(GpuResourceKind::Texture, id));
+    if (it == entries.end())
+        return;
+    Entry& entry = it->second;
+
+    // loadTexture 失败时留下的名字从未绑定过，还不是纹理对象，不能查询
+    if (!glIsTexture(id))
+    {
+        entry.width = entry.height = entry.levels = 0;
+        setBytes(entry, 0);
+        return;
+    }
+
+    GLint internalFormat = 0, maxLevel = 0;
+    glGetTextureLevelParameteriv(id, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    glGetTextureParameteriv(id, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+    entry.format = static_cast<GLenum>(internalFormat);
+
+    size_t bytes = 0;
+    int levels = 0;
+    for (int level = 0; level <= std::min(maxLevel, 15); ++level)
+    {
+        GLint w = 0, h = 0;
+        glGetTextureLevelParameteriv(id, level, GL_TEXTURE_WIDTH, &w);
+        glGetTextureLevelParameteriv(id, level, GL_TEXTURE_HEIGHT, &h);
+        if (w == 0 || h == 0)
+            break;
+        if (level == 0)
+        {
+            entry.width = w;
+            entry.height = h;
+        }
+        bytes += static_cast<size_t>(w) * h * bytesPerPixel(entry.format);
+        ++levels;
+    }
+    entry.levels = levels;
+    setBytes(entry, bytes);
+}
+
+void GpuRegistry::SetRenderbufferSize(unsigned int id, GLenum internalFormat, int width, int height)
+{
+    auto it = entries.find(makeKey(GpuResourceKind::Renderbuffer, id));
+    if (it == entries.end())
+        return;
+    Entry& entry = it->second;
+    entry.format = internalFormat;
+    entry.width = width;
+    entry.height = height;
+    entry.levels = 1;
+    setBytes(entry, static_cast<size_t>(width) * height * bytesPerPixel(internalFormat));
+}
+
+const GpuRegistry::Entry* GpuRegistry::Find(GpuResourceKind kind, unsigned int id) const
+{
+    auto it = entries.find(makeKey(kind, id));
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+size_t GpuRegistry::dropTopMip(Entry& entry)
+{
+    GLint immutable = GL_FALSE;
+    glGetTextureParameteriv(entry.id, GL_TEXTURE_IMMUTABLE_FORMAT, &immutable);
+    if (immutable || entry.levels < 2)
+        return 0;
+
+    // 读回 1..n-1 级，再在同一个名字上重新指定为 0..n-2 级
+    // 名字不变，DrawPacket / SceneResources 里记着的 ID 不受影响
+    std::vector<std::vector<unsigned char>> pixels(entry.levels - 1);
+    std::vector<GLint> widths(entry.levels - 1), heights(entry.levels - 1);
+    for (int level = 1; level < entry.levels; ++level)
+    {
+        GLint w = 0, h = 0;
+        glGetTextureLevelParameteriv(entry.id, level, GL_TEXTURE_WIDTH, &w);
+        glGetTextureLevelParameteriv(entry.id, level, GL_TEXTURE_HEIGHT, &h);
+        widths[level - 1] = w;
+        heights[level - 1] = h;
+        pixels[level - 1].resize(static_cast<size_t>(w) * h * 4);
+        glGetTextureImage(entry.id, level, GL_RGBA, GL_UNSIGNED_BYTE,
+            static_cast<GLsizei>(pixels[level - 1].size()), pixels[level - 1].data());
+    }
+
+    // 可变存储只能经由绑定点重新指定；恢复原绑定，GLStateCache 记录的状态保持不变
+    GLint previous = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    for (int level = 0; level < entry.levels - 1; ++level)
+        glTexImage2D(GL_TEXTURE_2D, level, entry.format, widths[level], heights[level], 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels[level].data());
+    // 原来最小的那一级留在 max level 之外，不参与完整性检查
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry.levels - 2);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+
+    size_t before = entry.bytes;
+    RefreshTexture(entry.id);
+    totals.mipDrops++;
+    return before > entry.bytes ? before - entry.bytes : 0;
+}
+
+size_t GpuRegistry::Enforce()
+{
+    size_t freed = 0;
+    while (OverBudget())
+    {
+        // 最大的可降级纹理丢一级 mip
+        Entry* largest = nullptr;
+        for (auto& item : entries)
+        {
+            Entry& e = item.second;
+            if (e.kind == GpuResourceKind::Texture && e.residency == GpuResidency::MipDroppable &&
+                e.levels > 1 && std::max(e.width, e.height) > MIN_DROP_SIZE && (!largest || e.bytes > largest->bytes))
+                largest = &e;
+        }
+        if (!largest)
+            break;
+
+        size_t saved = dropTopMip(*largest);
+        if (saved == 0)
+            largest->residency = GpuResidency::Pinned;   // 不可变存储等情况，以后不再尝试
+        freed += saved;
+    }
+
+    if (OverBudget() && !warnedBudget)
+    {
+        std::printf("WARNING::GPU_REGISTRY:: %.2f MB in use, budget %.2f MB, nothing left to drop\n",
+            totals.Bytes() / 1048576.0, budget / 1048576.0);
+        warnedBudget = true;
+    }
+    return freed;
+}
+
+size_t GpuRegistry::ReportLeaks() const
+{
+    for (const auto& item : entries)
+    {
+        const Entry& e = item.second;
+        std::printf("WARNING::GPU_REGISTRY:: leaked %s %u (%s, %zu B)\n", kindName(e.kind), e.id, e.owner.c_str(), e.bytes);
+    }
+    return entries.size();
+}
+
+// ---------------------------------------------------------------------------
+
+GpuHandle::GpuHandle(GpuResourceKind kind, unsigned int id, const std::string& owner, GpuResidency residency)
+    : kind(kind), id(id)
+{
+    GpuRegistry::Get().Register(kind, id, owner, residency);
+}
+
+GpuHandle::GpuHandle(GpuHandle&& other) noexcept
+    : kind(other.kind), id(other.id)
+{
+    other.id = 0;
+}
+
+GpuHandle& GpuHandle::operator=(GpuHandle&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        kind = other.kind;
+        id = other.id;
+        other.id = 0;
+    }
+    return *this;
+}
+
+void GpuHandle::Reset()
+{
+    if (id == 0)
+        return;
+
+    GpuRegistry::Get().Unregister(kind, id);
+    switch (kind)
+    {
+    case GpuResourceKind::Buffer: glDeleteBuffers(1, &id); break;
+    case GpuResourceKind::Texture: glDeleteTextures(1, &id); break;
+    case GpuResourceKind::Renderbuffer: glDeleteRenderbuffers(1, &id); break;
+    case GpuResourceKind::VertexArray: glDeleteVertexArrays(1, &id); break;
+    }
+    id = 0;
+}
+
+static unsigned int createBuffer()
+{
+    unsigned int id = 0;
+    glCreateBuffers(1, &id);
+    return id;
+}
+
+GpuBuffer::GpuBuffer(const std::string& owner, GpuResidency residency)
+    : GpuHandle(GpuResourceKind::Buffer, createBuffer(), owner, residency)
+{
+}
+
+void GpuBuffer::Allocate(size_t bytes, const void* data, GLenum usage)
+{
+    glNamedBufferData(id, static_cast<GLsizeiptr>(bytes), data, usage);
+    GpuRegistry::Get().SetBufferSize(id, bytes, usage);
+}
+
+void GpuBuffer::Storage(size_t bytes, const void* data, GLbitfield flags)
+{
+    glNamedBufferStorage(id, static_cast<GLsizeiptr>(bytes), data, flags);
+    GpuRegistry::Get().SetBufferSize(id, bytes, flags);
+}
+
+GpuTexture GpuTexture::Adopt(unsigned int id, const std::string& owner, GpuResidency residency)
+{
+    GpuTexture texture(id, owner, residency);
+    GpuRegistry::Get().RefreshTexture(id);
+    return texture;
+}
+
+static unsigned int createRenderbuffer()
+{
+    unsigned int id = 0;
+    glCreateRenderbuffers(1, &id);
+    return id;
+}
+
+GpuRenderbuffer::GpuRenderbuffer(const std::string& owner)
+    : GpuHandle(GpuResourceKind::Renderbuffer, createRenderbuffer(), owner, GpuResidency::Pinned)
+{
+}
+
+void GpuRenderbuffer::Storage(GLenum internalFormat, int width, int height)
+{
+    glNamedRenderbufferStorage(id, internalFormat, width, height);
+    GpuRegistry::Get().SetRenderbufferSize(id, internalFormat, width, height);
+}
+
+static unsigned int createVertexArray()
+{
+    unsigned int id = 0;
+    glCreateVertexArrays(1, &id);
+    return id;
+}
+
+GpuVertexArray::GpuVertexArray(const std::string& owner)
+    : GpuHandle(GpuResourceKind::VertexArray, createVertexArray(), owner, GpuResidency::Pinned)
+{
+}
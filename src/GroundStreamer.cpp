@@ -0,0 +1,251 @@
+#include "GroundStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+// 原来 50x50 平面的角点：uv 仍以它为原点，纹理相位与改动前一致
+static const float UV_ORIGIN = 25.0f;
+
+GroundStreamer::GroundStreamer(unsigned int framesInFlight)
+    : slots(SLOT_COUNT), framesInFlight(std::max(framesInFlight, 1u))
+{
+    // 整个池一次分配好，之后只用 glNamedBufferSubData 覆盖某个槽
+    const size_t slotBytes = VERTICES_PER_TILE * FLOATS_PER_VERTEX * sizeof(float);
+    pool = GpuBuffer("ground tile pool");
+    pool.Storage(slotBytes * SLOT_COUNT, NULL, GL_DYNAMIC_STORAGE_BIT);
+
+    // 顶点格式与原来的地面平面一致：pos(3) normal(3) uv(2)
+    VAO = GpuVertexArray("ground tiles");
+    glVertexArrayVertexBuffer(VAO.ID(), 0, pool.ID(), 0, FLOATS_PER_VERTEX * sizeof(float));
+    const GLint sizes[3] = { 3, 3, 2 };
+    const GLuint offsets[3] = { 0, 3, 6 };
+    for (GLuint attrib = 0; attrib < 3; ++attrib)
+    {
+        glEnableVertexArrayAttrib(VAO.ID(), attrib);
+        glVertexArrayAttribFormat(VAO.ID(), attrib, sizes[attrib], GL_FLOAT, GL_FALSE, offsets[attrib] * sizeof(float));
+        glVertexArrayAttribBinding(VAO.ID(), attrib, 0);
+    }
+
+    worker = std::thread(&GroundStreamer::workerLoop, this);
+}
+
+GroundStreamer::~GroundStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+glm::ivec2 GroundStreamer::tileOf(const glm::vec3& position)
+{
+    return glm::ivec2(static_cast<int>(std::floor(position.x / TILE_SIZE)), static_cast<int>(std::floor(position.z / TILE_SIZE)));
+}
+
+void GroundStreamer::generateTile(glm::ivec2 coord, std::vector<float>& vertices)
+{
+    // patch 控制点顺序 (u0,v0) (u1,v0) (u1,v1) (u0,v1)，与 ground.tese 的插值约定一致
+    // 纹理坐标沿用原平面的公式 (每 2 米一个周期)，只依赖世界坐标，地块之间无缝
+    const float patchSize = TILE_SIZE / PATCHES_PER_TILE;
+    const float originX = coord.x * TILE_SIZE;
+    const float originZ = coord.y * TILE_SIZE;
+    const unsigned int corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+    vertices.clear();
+    vertices.reserve(VERTICES_PER_TILE * FLOATS_PER_VERTEX);
+    for (unsigned int pz = 0; pz < PATCHES_PER_TILE; ++pz)
+    {
+        for (unsigned int px = 0; px < PATCHES_PER_TILE; ++px)
+        {
+            for (const auto& c : corners)
+            {
+                float x = originX + (px + c[0]) * patchSize;
+                float z = originZ + (pz + c[1]) * patchSize;
+                float vertex[] = {
+                    x, 0.0f, z,   0.0f, 1.0f, 0.0f,   (x + UV_ORIGIN) * 0.5f, (UV_ORIGIN - z) * 0.5f
+                };
+                vertices.insert(vertices.end(), vertex, vertex + FLOATS_PER_VERTEX);
+            }
+        }
+    }
+}
+
+void GroundStreamer::Prefill(const glm::vec3& cameraPos)
+{
+    glm::ivec2 center = tileOf(cameraPos);
+    TileData tile;
+    for (int dz = -VISIBLE_RADIUS; dz <= VISIBLE_RADIUS; ++dz)
+    {
+        for (int dx = -VISIBLE_RADIUS; dx <= VISIBLE_RADIUS; ++dx)
+        {
+            tile.coord = center + glm::ivec2(dx, dz);
+            if (residentSlots.count(makeKey(tile.coord)))
+                continue;
+            generateTile(tile.coord, tile.vertices);
+            upload(tile);
+        }
+    }
+    lastPosition = cameraPos;
+    hasPosition = true;
+}
+
+void GroundStreamer::request(glm::ivec2 coord)
+{
+    uint64_t key = makeKey(coord);
+    if (pending.count(key) || pending.size() >= MAX_PENDING)
+        return;
+    pending.insert(key);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(coord);
+    }
+    wake.notify_one();
+    stats.requests++;
+}
+
+void GroundStreamer::upload(TileData& tile)
+{
+    uint64_t key = makeKey(tile.coord);
+    pending.erase(key);
+    if (residentSlots.count(key))
+        return;
+
+    // 优先用空槽，否则取最久没用过的。不能覆盖的槽：
+    //   本帧用到的 (可见 / 预取)，以及前 framesInFlight - 1 帧画过的——FramePacer 在 BeginFrame 只保证
+    //   更早的帧已经执行完，这些帧的绘制 GPU 可能还没读完，覆盖时驱动只能隐式等待 GPU 或另拷一份缓冲
+    unsigned int victim = SLOT_COUNT;
+    for (unsigned int i = 0; i < SLOT_COUNT; ++i)
+    {
+        if (!slots[i].valid) { victim = i; break; }
+        if (slots[i].lastUsedFrame + framesInFlight <= frame && (victim == SLOT_COUNT || slots[i].lastUsedFrame < slots[victim].lastUsedFrame))
+            victim = i;
+    }
+    if (victim == SLOT_COUNT)
+    {
+        stats.discarded++;
+        return;
+    }
+
+    Slot& slot = slots[victim];
+    if (slot.valid)
+    {
+        residentSlots.erase(makeKey(slot.coord));
+        stats.evictions++;
+    }
+    const size_t slotBytes = VERTICES_PER_TILE * FLOATS_PER_VERTEX * sizeof(float);
+    glNamedBufferSubData(pool.ID(), victim * slotBytes, slotBytes, tile.vertices.data());
+
+    slot.coord = tile.coord;
+    slot.valid = true;
+    slot.lastUsedFrame = frame;
+    residentSlots[key] = victim;
+    stats.uploads++;
+    stats.resident = static_cast<unsigned int>(residentSlots.size());
+}
+
+void GroundStreamer::addDrawTile(unsigned int slot, glm::ivec2 coord)
+{
+    DrawTile tile;
+    tile.first = slot * VERTICES_PER_TILE;
+    tile.center = (glm::vec2(coord) + 0.5f) * TILE_SIZE;
+    drawTiles.push_back(tile);
+}
+
+void GroundStreamer::Update(const glm::vec3& cameraPos, float dt)
+{
+    ++frame;
+
+    // --- 1. 速度 (指数平滑，抑制单帧抖动) ---
+    if (hasPosition && dt > 0.0f)
+        velocity = glm::mix(velocity, (cameraPos - lastPosition) / dt, 0.2f);
+    lastPosition = cameraPos;
+    hasPosition = true;
+
+    // --- 2. 可见圈：命中的刷新 LRU，缺的由近到远请求 ---
+    glm::ivec2 center = tileOf(cameraPos);
+    drawTiles.clear();
+    std::vector<glm::ivec2> missing;
+    for (int dz = -VISIBLE_RADIUS; dz <= VISIBLE_RADIUS; ++dz)
+    {
+        for (int dx = -VISIBLE_RADIUS; dx <= VISIBLE_RADIUS; ++dx)
+        {
+            glm::ivec2 coord = center + glm::ivec2(dx, dz);
+            stats.lookups++;
+            auto it = residentSlots.find(makeKey(coord));
+            if (it != residentSlots.end())
+            {
+                stats.hits++;
+                slots[it->second].lastUsedFrame = frame;
+                addDrawTile(it->second, coord);
+            }
+            else
+            {
+                missing.push_back(coord);
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end(), [center](glm::ivec2 a, glm::ivec2 b) {
+        glm::ivec2 da = a - center, db = b - center;
+        return da.x * da.x + da.y * da.y < db.x * db.x + db.y * db.y;
+    });
+    for (glm::ivec2 coord : missing)
+        request(coord);
+
+    // --- 3. 预取圈：外推位置周围的地块，已在池里的同样刷新 LRU ---
+    glm::ivec2 ahead = tileOf(cameraPos + glm::vec3(velocity.x, 0.0f, velocity.z) * PREFETCH_SECONDS);
+    for (int dz = -VISIBLE_RADIUS; dz <= VISIBLE_RADIUS; ++dz)
+    {
+        for (int dx = -VISIBLE_RADIUS; dx <= VISIBLE_RADIUS; ++dx)
+        {
+            glm::ivec2 coord = ahead + glm::ivec2(dx, dz);
+            auto it = residentSlots.find(makeKey(coord));
+            if (it != residentSlots.end())
+                slots[it->second].lastUsedFrame = frame;
+            else
+                request(coord);
+        }
+    }
+
+    // --- 4. 取走后台已完成的结果 (只在交换列表时持锁)，每帧最多上传 UPLOADS_PER_FRAME 块 ---
+    std::vector<TileData> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = std::min<size_t>(completed.size(), UPLOADS_PER_FRAME);
+        ready.assign(std::make_move_iterator(completed.begin()), std::make_move_iterator(completed.begin() + count));
+        completed.erase(completed.begin(), completed.begin() + count);
+    }
+    for (TileData& tile : ready)
+    {
+        bool wasMissing = std::find(missing.begin(), missing.end(), tile.coord) != missing.end();
+        upload(tile);
+        // 本帧可见但刚到的地块直接画上，不用再等一帧
+        auto it = residentSlots.find(makeKey(tile.coord));
+        if (wasMissing && it != residentSlots.end())
+            addDrawTile(it->second, tile.coord);
+    }
+}
+
+void GroundStreamer::workerLoop()
+{
+    for (;;)
+    {
+        glm::ivec2 coord;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping)
+                return;
+            coord = requests.front();
+            requests.pop_front();
+        }
+
+        TileData tile;
+        tile.coord = coord;
+        generateTile(coord, tile.vertices);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.push_back(std::move(tile));
+    }
+}
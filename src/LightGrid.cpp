@@ -0,0 +1,152 @@
+#include "LightGrid.h"
+#include <algorithm>
+#include <cmath>
+
+LightGrid::LightGrid()
+{
+    const char* owners[4] = { "light grid lights", "light grid clusters", "light grid indices", "light grid params" };
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        SSBO[i] = GpuBuffer(owners[i]);
+        capacity[i] = 0;
+    }
+}
+
+void LightGrid::Build(const std::vector<PointLight>& lights, const std::vector<RenderView>& views, float zNear, float zFar)
+{
+    // Z 切片：slice = log(depth) * zScale - zBias，近处切得细、远处切得粗
+    float logRatio = std::log(zFar / zNear);
+    float zScale = GRID_Z / logRatio;
+    float zBias = GRID_Z * std::log(zNear) / logRatio;
+    unsigned int viewCount = static_cast<unsigned int>(views.size());
+    gridParams.dims = glm::uvec4(GRID_X, GRID_Y, GRID_Z, viewCount);
+    gridParams.params = glm::vec4(zScale, zBias, 0.0f, 0.0f);
+
+    auto sliceOf = [&](float depth) {
+        int s = static_cast<int>(std::floor(std::log(depth) * zScale - zBias));
+        return static_cast<unsigned int>(glm::clamp(s, 0, static_cast<int>(GRID_Z) - 1));
+    };
+    auto tileOf = [](float ndc, unsigned int tiles) {
+        int t = static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles));
+        return static_cast<unsigned int>(glm::clamp(t, 0, static_cast<int>(tiles) - 1));
+    };
+
+    // 灯光数组所有视图共用，按原顺序全部上传
+    gpuLights.clear();
+    for (const PointLight& light : lights)
+        gpuLights.push_back({ glm::vec4(light.position, light.range), glm::vec4(light.color, 0.0f) });
+
+    // --- 1. 每个视图里，每盏灯求出覆盖的簇范围 (视锥外的灯直接丢弃) ---
+    bounds.clear();
+    boundsLight.clear();
+    for (unsigned int v = 0; v < viewCount; ++v)
+    {
+        const glm::mat4& view = views[v].view;
+        const glm::mat4& projection = views[v].projection;
+
+        for (size_t l = 0; l < lights.size(); ++l)
+        {
+            const PointLight& light = lights[l];
+            glm::vec3 c = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            float r = light.radius;
+            float depthMin = -c.z - r;
+            float depthMax = -c.z + r;
+            if (depthMax < zNear || depthMin > zFar)
+                continue;
+
+            LightBounds b;
+            b.view = v;
+            b.z0 = sliceOf(std::max(depthMin, zNear));
+            b.z1 = sliceOf(std::min(depthMax, zFar));
+
+            if (depthMin <= zNear)
+            {
+                // 包围球跨过近平面，投影不再保守，直接覆盖整个视口
+                b.x0 = 0; b.x1 = GRID_X - 1;
+                b.y0 = 0; b.y1 = GRID_Y - 1;
+            }
+            else
+            {
+                // 投影包围盒的 8 个角点，取 NDC 上的包围矩形
+                glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+                for (int corner = 0; corner < 8; ++corner)
+                {
+                    glm::vec3 p = c + glm::vec3((corner & 1) ? r : -r, (corner & 2) ? r : -r, (corner & 4) ? r : -r);
+                    glm::vec4 clip = projection * glm::vec4(p, 1.0f);
+                    glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                    ndcMin = glm::min(ndcMin, ndc);
+                    ndcMax = glm::max(ndcMax, ndc);
+                }
+                if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                    continue;
+
+                b.x0 = tileOf(ndcMin.x, GRID_X); b.x1 = tileOf(ndcMax.x, GRID_X);
+                b.y0 = tileOf(ndcMin.y, GRID_Y); b.y1 = tileOf(ndcMax.y, GRID_Y);
+            }
+
+            boundsLight.push_back(static_cast<uint32_t>(l));
+            bounds.push_back(b);
+        }
+    }
+
+    // --- 2. 计数 -> 前缀和 -> 填充 (两遍扫描，不需要每簇一个动态数组) ---
+    clusters.assign(static_cast<size_t>(CLUSTER_COUNT) * viewCount, { 0, 0 });
+
+    auto clusterIndex = [](unsigned int view, unsigned int x, unsigned int y, unsigned int z) {
+        return view * CLUSTER_COUNT + (z * GRID_Y + y) * GRID_X + x;
+    };
+
+    for (const LightBounds& b : bounds)
+        for (unsigned int z = b.z0; z <= b.z1; ++z)
+            for (unsigned int y = b.y0; y <= b.y1; ++y)
+                for (unsigned int x = b.x0; x <= b.x1; ++x)
+                    clusters[clusterIndex(b.view, x, y, z)].count++;
+
+    uint32_t offset = 0;
+    activeClusters = 0;
+    for (ClusterRange& cluster : clusters)
+    {
+        cluster.offset = offset;
+        offset += cluster.count;
+        activeClusters += cluster.count > 0 ? 1 : 0;
+        cluster.count = 0;
+    }
+
+    lightIndices.resize(offset);
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        const LightBounds& b = bounds[i];
+        for (unsigned int z = b.z0; z <= b.z1; ++z)
+            for (unsigned int y = b.y0; y <= b.y1; ++y)
+                for (unsigned int x = b.x0; x <= b.x1; ++x)
+                {
+                    ClusterRange& cluster = clusters[clusterIndex(b.view, x, y, z)];
+                    lightIndices[cluster.offset + cluster.count++] = boundsLight[i];
+                }
+    }
+}
+
+void LightGrid::uploadBuffer(unsigned int index, const void* data, size_t bytes)
+{
+    // 空数组也要有一个合法的缓冲区，shader 里按 count 访问不会越界
+    size_t size = std::max<size_t>(bytes, 16);
+
+    if (size > capacity[index])
+    {
+        // 容量按 2 倍增长，灯多了也不会每帧重新分配
+        capacity[index] = std::max(size, capacity[index] * 2);
+        SSBO[index].Allocate(capacity[index], NULL, GL_DYNAMIC_DRAW);
+    }
+    if (bytes > 0)
+        glNamedBufferSubData(SSBO[index].ID(), 0, bytes, data);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, SSBO[index].ID());
+}
+
+void LightGrid::Upload()
+{
+    uploadBuffer(0, gpuLights.data(), gpuLights.size() * sizeof(GpuLight));
+    uploadBuffer(1, clusters.data(), clusters.size() * sizeof(ClusterRange));
+    uploadBuffer(2, lightIndices.data(), lightIndices.size() * sizeof(uint32_t));
+    uploadBuffer(3, &gridParams, sizeof(GridParams));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
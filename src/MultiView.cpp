@@ -0,0 +1,119 @@
+#include "MultiView.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+MultiView::MultiView()
+{
+    // 每块区域按 UBO 偏移对齐，才能用 glBindBufferRange 单独绑定
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    regionSize = (MAX_VIEWS * sizeof(GpuView) + alignment - 1) / alignment * alignment;
+
+    // 持久映射：只映射一次，之后每帧直接 memcpy，没有 glBufferSubData 的驱动拷贝和隐式同步
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    UBO = GpuBuffer("multiview camera ring");
+    UBO.Storage(regionSize * RING_SIZE, NULL, flags);
+    mapped = static_cast<unsigned char*>(glMapNamedBufferRange(UBO.ID(), 0, regionSize * RING_SIZE, flags));
+    for (unsigned int i = 0; i < RING_SIZE; ++i)
+        fences[i] = 0;
+
+    maxViews = IsSupported() ? MAX_VIEWS : 1;
+    GLint viewports = 0;
+    glGetIntegerv(GL_MAX_VIEWPORTS, &viewports);
+    maxViews = std::min(maxViews, static_cast<unsigned int>(std::max(viewports, 1)));
+}
+
+MultiView::~MultiView()
+{
+    for (unsigned int i = 0; i < RING_SIZE; ++i)
+        if (fences[i]) glDeleteSync(fences[i]);
+    glUnmapNamedBuffer(UBO.ID());
+}
+
+bool MultiView::IsSupported()
+{
+    // 生成的 glad 只有核心函数，扩展要自己查
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && std::strcmp(name, "GL_ARB_shader_viewport_layer_array") == 0)
+            return true;
+    }
+    return false;
+}
+
+void MultiView::SetViews(const std::vector<RenderView>& views)
+{
+    if (views.size() > maxViews)
+    {
+        static bool warned = false;
+        if (!warned)
+        {
+            std::cout << "WARNING::MULTIVIEW:: only " << maxViews << " view(s) supported, extra views are dropped" << std::endl;
+            warned = true;
+        }
+        this->views.assign(views.begin(), views.begin() + maxViews);
+    }
+    else
+    {
+        this->views = views;
+    }
+}
+
+void MultiView::Upload()
+{
+    // 上一块区域最后被用到就是上一帧：此刻插 fence 正好覆盖上一帧的全部绘制
+    if (uploaded)
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % RING_SIZE;
+    uploaded = true;
+
+    // 轮到的区域还可能被 RING_SIZE 帧之前的绘制读取，等它完成再覆盖
+    // (FramePacer 把在途帧数限制在 RING_SIZE 以下时，这里不会真的等)
+    if (fences[region])
+    {
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (glClientWaitSync(fences[region], flags, 1000000) == GL_TIMEOUT_EXPIRED)
+            flags = 0;
+        glDeleteSync(fences[region]);
+        fences[region] = 0;
+    }
+
+    GpuView* data = reinterpret_cast<GpuView*>(mapped + region * regionSize);
+    for (size_t i = 0; i < views.size(); ++i)
+    {
+        data[i].view = views[i].view;
+        data[i].projection = views[i].projection;
+        data[i].position = glm::vec4(views[i].position, 1.0f);
+        data[i].viewport = views[i].viewport;
+        glViewportIndexedf(static_cast<GLuint>(i), views[i].viewport.x, views[i].viewport.y, views[i].viewport.z, views[i].viewport.w);
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, UBO_BINDING, UBO.ID(), region * regionSize, regionSize);
+}
+
+std::vector<RenderView> MultiView::SideBySide(unsigned int count, const glm::vec3& position, const glm::vec3& front,
+    const glm::vec3& up, const glm::vec3& right, float fovY, float width, float height,
+    float zNear, float zFar, float separation)
+{
+    std::vector<RenderView> result;
+    count = std::max(count, 1u);
+    float viewWidth = width / count;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // 以相机为中心左右对称排开
+        float offset = (static_cast<float>(i) - (count - 1) * 0.5f) * separation;
+        RenderView v;
+        v.position = position + right * offset;
+        v.view = glm::lookAt(v.position, v.position + front, up);
+        v.projection = glm::perspective(glm::radians(fovY), viewWidth / height, zNear, zFar);
+        v.viewport = glm::vec4(viewWidth * i, 0.0f, viewWidth, height);
+        result.push_back(v);
+    }
+    return result;
+}
@@ -1,40 +1,27 @@
 #include "ParticleSystem.h"
 #include <iostream>
 
-// 
-float randomFloat(float min, float max) {
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
-}
-
-ParticleSystem::ParticleSystem(Shader& shader, unsigned int amount)
-    : shader(shader), amount(amount)
+template<typename Effect>
+ParticleSystem<Effect>::ParticleSystem(unsigned int amount, const Params& params)
+    : amount(amount), params(params)
 {
     this->init();
 }
 
-void ParticleSystem::init()
+template<typename Effect>
+void ParticleSystem<Effect>::init()
 {
-    // --- 1. ʼ DOD  ---
-    particleRenderData.resize(amount);
-    particleVelocities.resize(amount);
-
-    for (unsigned int i = 0; i < amount; ++i)
+    // --- 1. 初始化 DOD 数组 ---
+    // 列内存来自大页 arena，first touch 发生在当前线程 (也就是之后调用 Update 的线程)
+    if (!particles.Allocate(amount))
     {
-        // [޸] Χ΢Сһ㣬ˮΧ
-        float x = randomFloat(-20.0f, 20.0f);
-        // [޸] ߶ȷΧ 0~40 ѹ 10~30 20 ףߴֱܶ
-        // Ļ׼߶ raised  10.0f ϣɾͿڵ
-        float y = randomFloat(10.0f, 30.0f);
-        float z = randomFloat(-20.0f, 20.0f);
-
-        float randomScale = randomFloat(0.5f, 1.5f);
-        particleRenderData[i] = glm::vec4(x, y, z, randomScale);
-
-        // [޸] ΢ӿһٶȣӱ
-        particleVelocities[i] = glm::vec3(0.0f, randomFloat(-30.0f, -45.0f), 0.0f);
+        std::cout << "ERROR::PARTICLESYSTEM:: Failed to allocate particle columns" << std::endl;
+        amount = 0;
     }
+    for (unsigned int i = 0; i < amount; ++i)
+        Effect::Spawn(particles, i, params);
 
-    // --- 2.  OpenGL ---
+    // --- 2. 配置 OpenGL ---
     float quadVertices[] = {
         -0.5f, -0.5f, 0.0f,
          0.5f, -0.5f, 0.0f,
@@ -44,66 +31,89 @@ void ParticleSystem::init()
          0.5f,  0.5f, 0.0f
     };
 
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->quadVBO);
-    glGenBuffers(1, &this->instanceVBO);
+    this->VAO = GpuVertexArray("particles");
+    this->quadVBO = GpuBuffer("particles quad");
+    this->quadVBO.Allocate(sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
-    glBindVertexArray(this->VAO);
+    glBindVertexArray(this->VAO.ID());
 
-    glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO.ID());
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
-    // [ؼ] ԤԴ棬ʹ GL_DYNAMIC_DRAW Ϊÿһ֡
-    glBufferData(GL_ARRAY_BUFFER, amount * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
-    glVertexAttribDivisor(2, 1);
+    // 每个 GPU 列生成一个缓冲：实例属性取数时属性位置由列的 location 决定，SSBO 取数时不占顶点属性
+    particles.ForEachColumn([this](auto column, size_t index, auto* data) {
+        using Column = decltype(column);
+        using T = typename Column::type;
+        (void)data;
+        if constexpr (Column::location >= 0 && Effect::Fetch == ParticleFetch::InstanceAttrib)
+        {
+            this->columnVBO[index] = GpuBuffer("particles instance column");
+            // [关键] 预分配显存，使用 GL_DYNAMIC_DRAW 因为每一帧都会更新
+            this->columnVBO[index].Allocate(amount * sizeof(T), NULL, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, this->columnVBO[index].ID());
+            glEnableVertexAttribArray(Column::location);
+            glVertexAttribPointer(Column::location, GLAttribFormat<T>::components, GL_FLOAT, GL_FALSE, sizeof(T), (void*)0);
+            glVertexAttribDivisor(Column::location, 1);
+        }
+        else if constexpr (Column::location >= 0)
+        {
+            this->columnVBO[index] = GpuBuffer("particles storage column");
+            this->columnVBO[index].Allocate(amount * sizeof(T), NULL, GL_DYNAMIC_DRAW);
+        }
+    });
 
     glBindVertexArray(0);
 }
 
-void ParticleSystem::Update(float dt, glm::vec2 cameraPos)
+template<typename Effect>
+void ParticleSystem<Effect>::Update(float dt, glm::vec2 cameraPos)
 {
-    // --- [˵Ż] һûκ if-else ֧Ĵѭ ---
-    // ִ CPU ϲڴ߼֧ѭִЧʣ
-    for (unsigned int i = 0; i < amount; ++i)
-    {
-        // 1.  (ӷ)
-        particleRenderData[i].x += particleVelocities[i].x * dt;
-        particleRenderData[i].y += particleVelocities[i].y * dt;
-        particleRenderData[i].z += particleVelocities[i].z * dt;
+    // 更新内核在编译期内联，生成的循环与手写版本一致
+    Effect::Update(particles, dt, cameraPos, params);
+}
 
-        // 2. Դؼ ( if-else ֧ļֱжϲ)
-        if (particleRenderData[i].y < -2.0f)
+template<typename Effect>
+void ParticleSystem<Effect>::Upload()
+{
+    // --- [核弹级优化 2] 零拷贝直接提交数据 ---
+    // 不再每一帧 new 和 delete vector。
+    // 因为每个 GPU 列的底层内存布局就是紧凑数组，直接传指针给 GPU！
+    particles.ForEachColumn([this](auto column, size_t index, auto* data) {
+        using Column = decltype(column);
+        if constexpr (Column::location >= 0 && Effect::Fetch == ParticleFetch::InstanceAttrib)
         {
-            particleRenderData[i].y = 40.0f; // ص߿
-
-            // Χֲһֱߣ
-            particleRenderData[i].x = cameraPos.x + randomFloat(-25.0f, 25.0f);
-            particleRenderData[i].z = cameraPos.y + randomFloat(-25.0f, 25.0f);
+            glBindBuffer(GL_ARRAY_BUFFER, this->columnVBO[index].ID());
+            // 使用 glBufferSubData 仅替换数据，不重新分配内存
+            glBufferSubData(GL_ARRAY_BUFFER, 0, amount * sizeof(typename Column::type), data);
         }
-    }
+        else if constexpr (Column::location >= 0)
+        {
+            // SSBO 绑定点是全局状态，和 LightGrid 一样在上传时绑定，DrawPacket 不用关心
+            glNamedBufferSubData(this->columnVBO[index].ID(), 0, amount * sizeof(typename Column::type), data);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STORAGE_BINDING_BASE + Storage::template GpuSlot<Column>(), this->columnVBO[index].ID());
+        }
+    });
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void ParticleSystem::Draw(glm::vec3 cameraPos)
+template<typename Effect>
+void ParticleSystem<Effect>::SetViewCount(unsigned int views)
 {
-    // --- [˵Ż 2] 㿽ֱύ ---
-    // ÿһ֡ new  delete vector
-    // Ϊ particleRenderData ĵײڴ沼־ǽյ vec4 飬ֱӴָ GPU
-    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
-
-    // ʹ glBufferSubData 滻ݣ·ڴ
-    glBufferSubData(GL_ARRAY_BUFFER, 0, amount * sizeof(glm::vec4), particleRenderData.data());
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    this->shader.use();
-    this->shader.setVec3("cameraPos", cameraPos);
+    if (views == viewCount)
+        return;
+    viewCount = views;
+
+    // 用 DSA 改 divisor，不动当前绑定的 VAO (GLStateCache 记录着它)
+    particles.ForEachColumn([this](auto column, size_t index, auto* data) {
+        using Column = decltype(column);
+        (void)index;
+        (void)data;
+        if constexpr (Column::location >= 0 && Effect::Fetch == ParticleFetch::InstanceAttrib)
+            glVertexArrayBindingDivisor(this->VAO.ID(), Column::location, this->viewCount);
+    });
+}
 
-    glBindVertexArray(this->VAO);
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, amount);
-    glBindVertexArray(0);
-}
\ No newline at end of file
+// 显式实例化：模板实现留在 .cpp，新特效在这里登记一行即可
+template class ParticleSystem<RainEffect>;
+template class ParticleSystem<SnowEffect>;
@@ -0,0 +1,102 @@
+#include "RainLayers.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 圆柱的分段数：半径最大的层在屏幕上也看不出折线
+static const unsigned int CYLINDER_SEGMENTS = 64;
+
+// 雨丝纹理：256 x 256，对应世界空间 4m (宽) x 8m (高)，与 rain_far.vert 中的 TILE_SIZE 一致
+static const int STREAK_TEXTURE_SIZE = 256;
+static const int STREAK_COUNT = 420;
+
+RainLayers::RainLayers(const RainEffect::Params& nearParams, const Config& config)
+    : nearParams(nearParams), config(config)
+{
+    createCylinder();
+    createStreakTexture();
+}
+
+void RainLayers::createCylinder()
+{
+    // 单位圆柱：x = 绕圈比例 [0,1]，y = 高度比例 [0,1]
+    // 半径、高度、相机跟随都在 shader 里按层计算，所有层共用这一份顶点
+    std::vector<float> vertices;
+    vertices.reserve(CYLINDER_SEGMENTS * 6 * 2);
+    for (unsigned int i = 0; i < CYLINDER_SEGMENTS; ++i)
+    {
+        float u0 = static_cast<float>(i) / CYLINDER_SEGMENTS;
+        float u1 = static_cast<float>(i + 1) / CYLINDER_SEGMENTS;
+        float quad[] = {
+            u0, 0.0f,  u1, 0.0f,  u0, 1.0f,
+            u0, 1.0f,  u1, 0.0f,  u1, 1.0f
+        };
+        vertices.insert(vertices.end(), quad, quad + 12);
+    }
+    vertexCount = static_cast<unsigned int>(vertices.size() / 2);
+
+    VAO = GpuVertexArray("rain layers");
+    VBO = GpuBuffer("rain layers cylinder");
+    VBO.Allocate(vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(VAO.ID());
+    glBindBuffer(GL_ARRAY_BUFFER, VBO.ID());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+}
+
+void RainLayers::createStreakTexture()
+{
+    const int size = STREAK_TEXTURE_SIZE;
+    std::vector<float> accum(size * size, 0.0f);
+
+    // 固定种子的 LCG：纹理每次启动都一样，也不打乱粒子用的 rand() 序列
+    uint32_t state = 0x9E3779B9u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / 16777216.0f;
+    };
+
+    // 每条雨丝：1~2 像素宽的竖线，两端渐隐；纵向和横向都按纹理尺寸回绕，保证可平铺
+    for (int n = 0; n < STREAK_COUNT; ++n)
+    {
+        float x = next() * size;
+        int y0 = static_cast<int>(next() * size);
+        int length = 6 + static_cast<int>(next() * 10.0f);   // 约 0.2 ~ 0.5 m，与近景雨滴长度相当
+        float intensity = 0.35f + next() * 0.65f;
+
+        int column = static_cast<int>(std::floor(x));
+        float frac = x - column;
+        for (int k = 0; k < length; ++k)
+        {
+            float t = (k + 0.5f) / length;
+            float profile = std::sin(t * 3.1415926f) * intensity;
+            int row = (y0 + k) % size;
+            accum[row * size + (column % size)] += profile * (1.0f - frac);
+            accum[row * size + ((column + 1) % size)] += profile * frac;
+        }
+    }
+
+    std::vector<unsigned char> data(size * size);
+    for (int i = 0; i < size * size; ++i)
+        data[i] = static_cast<unsigned char>(std::min(accum[i], 1.0f) * 255.0f);
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, data.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // 远处的雨丝不到一个像素，靠 mipmap 平均成一层均匀的"雨雾"
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 程序生成、只有 256 x 256，没必要降级
+    streakTexture = GpuTexture::Adopt(texture, "rain layers streaks");
+}
@@ -0,0 +1,208 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+// ---------------------------------------------------------
+// UniformValue
+// ---------------------------------------------------------
+
+UniformValue UniformValue::Int(GLint location, int value)
+{
+    UniformValue u{ location, Type::Int, {} };
+    u.data[0] = static_cast<float>(value);
+    return u;
+}
+
+UniformValue UniformValue::Float(GLint location, float value)
+{
+    UniformValue u{ location, Type::Float, {} };
+    u.data[0] = value;
+    return u;
+}
+
+UniformValue UniformValue::Vec3(GLint location, const glm::vec3& value)
+{
+    UniformValue u{ location, Type::Vec3, {} };
+    std::memcpy(u.data, glm::value_ptr(value), 3 * sizeof(float));
+    return u;
+}
+
+UniformValue UniformValue::Mat4(GLint location, const glm::mat4& value)
+{
+    UniformValue u{ location, Type::Mat4, {} };
+    std::memcpy(u.data, glm::value_ptr(value), 16 * sizeof(float));
+    return u;
+}
+
+size_t UniformValue::FloatCount() const
+{
+    switch (type)
+    {
+    case Type::Vec3: return 3;
+    case Type::Mat4: return 16;
+    default:         return 1;
+    }
+}
+
+// ---------------------------------------------------------
+// GLStateCache
+// ---------------------------------------------------------
+
+GLStateCache::GLStateCache()
+{
+    Invalidate();
+}
+
+void GLStateCache::Invalidate()
+{
+    // ~0u 不会是合法的 GL 名字，保证下一次调用一定发出
+    program = ~0u;
+    vao = ~0u;
+    activeUnit = ~0u;
+    for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; ++i)
+        textures[i] = ~0u;
+    uniforms.clear();
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if (this->program == program) { stats.stateSkipped++; return; }
+    this->program = program;
+    glUseProgram(program);
+    stats.stateChanges++;
+}
+
+void GLStateCache::BindVertexArray(unsigned int vao)
+{
+    if (this->vao == vao) { stats.stateSkipped++; return; }
+    this->vao = vao;
+    glBindVertexArray(vao);
+    stats.stateChanges++;
+}
+
+void GLStateCache::BindTexture(unsigned int unit, unsigned int texture)
+{
+    if (textures[unit] == texture) { stats.stateSkipped++; return; }
+    textures[unit] = texture;
+
+    // 不用 glBindTextureUnit：它要求纹理对象已经绑定过目标，
+    // 而 loadTexture 加载失败时留下的是从未绑定过的名字
+    if (activeUnit != unit)
+    {
+        activeUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    stats.stateChanges++;
+}
+
+void GLStateCache::SetUniform(const UniformValue& value)
+{
+    // uniform 是 program 对象的状态，调用前 program 必须已经绑定
+    uint64_t key = (static_cast<uint64_t>(program) << 32) | static_cast<uint32_t>(value.location);
+    size_t bytes = value.FloatCount() * sizeof(float);
+
+    auto it = uniforms.find(key);
+    if (it != uniforms.end() && it->second.type == value.type && std::memcmp(it->second.data, value.data, bytes) == 0)
+    {
+        stats.stateSkipped++;
+        return;
+    }
+
+    CachedUniform& cached = uniforms[key];
+    cached.type = value.type;
+    std::memcpy(cached.data, value.data, bytes);
+
+    switch (value.type)
+    {
+    case UniformValue::Type::Int:   glUniform1i(value.location, static_cast<int>(value.data[0])); break;
+    case UniformValue::Type::Float: glUniform1f(value.location, value.data[0]); break;
+    case UniformValue::Type::Vec3:  glUniform3fv(value.location, 1, value.data); break;
+    case UniformValue::Type::Mat4:  glUniformMatrix4fv(value.location, 1, GL_FALSE, value.data); break;
+    }
+    stats.stateChanges++;
+}
+
+// ---------------------------------------------------------
+// RenderQueue
+// ---------------------------------------------------------
+
+RenderQueue::RenderQueue(GLStateCache& cache)
+    : cache(cache)
+{
+}
+
+uint64_t RenderQueue::MakeKey(Pass pass, unsigned int program, unsigned int material, float depth)
+{
+    uint64_t d = static_cast<uint64_t>(glm::clamp(depth, 0.0f, 1.0f) * 0xFFFFFF);
+    uint64_t key = static_cast<uint64_t>(pass & 0xF) << 60;
+
+    if (pass == PASS_TRANSPARENT)
+    {
+        // 半透明必须由远到近，深度排在状态之前
+        key |= (0xFFFFFF - d) << 36;
+        key |= static_cast<uint64_t>(program & 0xFFF) << 24;
+        key |= static_cast<uint64_t>(material & 0xFFFF) << 8;
+    }
+    else
+    {
+        // 不透明按状态聚合，同状态内由近到远 (利用 early-z)
+        key |= static_cast<uint64_t>(program & 0xFFF) << 48;
+        key |= static_cast<uint64_t>(material & 0xFFFF) << 32;
+        key |= d << 8;
+    }
+    return key;
+}
+
+void RenderQueue::Submit(uint64_t key, const DrawPacket& packet, std::initializer_list<UniformValue> uniforms)
+{
+    DrawPacket p = packet;
+    p.uniformOffset = static_cast<uint32_t>(uniformData.size());
+    p.uniformCount = static_cast<uint32_t>(uniforms.size());
+    uniformData.insert(uniformData.end(), uniforms.begin(), uniforms.end());
+
+    order.push_back({ key, static_cast<uint32_t>(packets.size()) });
+    packets.push_back(p);
+}
+
+RenderStats RenderQueue::Execute(const std::function<void(Pass)>& onPassBegin)
+{
+    // 只排 (key, index) 对，不搬动 packet 本体
+    std::sort(order.begin(), order.end(), [](const SortEntry& a, const SortEntry& b) {
+        return a.key < b.key || (a.key == b.key && a.index < b.index);
+    });
+
+    cache.stats.Reset();
+    unsigned int currentPass = ~0u;
+    for (const SortEntry& entry : order)
+    {
+        const DrawPacket& p = packets[entry.index];
+
+        unsigned int pass = static_cast<unsigned int>(entry.key >> 60);
+        if (pass != currentPass)
+        {
+            currentPass = pass;
+            if (onPassBegin)
+                onPassBegin(static_cast<Pass>(pass));
+        }
+
+        cache.UseProgram(p.program);
+        for (uint32_t u = 0; u < p.uniformCount; ++u)
+            cache.SetUniform(uniformData[p.uniformOffset + u]);
+        for (unsigned int t = 0; t < p.textureCount; ++t)
+            cache.BindTexture(t, p.textures[t]);
+        cache.BindVertexArray(p.vao);
+
+        if (p.instanceCount > 1)
+            glDrawArraysInstanced(p.mode, p.first, p.count, p.instanceCount);
+        else
+            glDrawArrays(p.mode, p.first, p.count);
+        cache.stats.drawCalls++;
+    }
+
+    packets.clear();
+    order.clear();
+    uniformData.clear();
+    return cache.stats;
+}
@@ -1,76 +1,94 @@
 #include "Shader.h"
+#include "VirtualFileSystem.h"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <string_view>
 
-// 캯﷢һеħ
+// 构造函数：这里发生了这一章所有的魔法
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
+    : Shader(vertexPath, nullptr, nullptr, fragmentPath)
 {
-    // 1. ļ·лȡ/ƬɫԴ
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-
-    // ѧ 2쳣 (Exception Handling)
-    // ֤ ifstream ڶȡʧʱ׳쳣ĬĬʧ
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try
-    {
-        // ļ
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-
-        // ѧ 3stringstream (ַ)
-        //  C++ ȡıļЧŵд֮һ
-        // rdbuf() ֱӰļָ뵹
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-
-        // رļ (RAIIʵԶرգʽرǸϰ)
-        vShaderFile.close();
-        fShaderFile.close();
-
-        // ת string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
-    }
-
-    // ѧ 4C++ string ת C string
-    // OpenGL  C дģʶ std::string ֻʶ const char*
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+}
 
-    // 2. ɫ (֮ǰ main.cpp һֻǰᵽ)
-    unsigned int vertex, fragment;
+// 带细分阶段的版本：TCS / TES 路径为空时退化成普通的 顶点 + 片段 程序
+Shader::Shader(const char* vertexPath, const char* tessControlPath, const char* tessEvalPath, const char* fragmentPath)
+{
+    build(vertexPath, tessControlPath, tessEvalPath, fragmentPath, std::string());
+}
 
-    // ɫ
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX"); // ʹ÷װõļ麯
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const std::string& vertexDeclarations)
+{
+    build(vertexPath, nullptr, nullptr, fragmentPath, vertexDeclarations);
+}
 
-    // Ƭɫ
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+void Shader::build(const char* vertexPath, const char* tessControlPath, const char* tessEvalPath, const char* fragmentPath,
+    const std::string& vertexDeclarations)
+{
+    // 1. 编译各个阶段 (和之前 main.cpp 里的一样，只是搬到了这里)
+    unsigned int stages[4];
+    unsigned int stageCount = 0;
+    stages[stageCount++] = compileStage(GL_VERTEX_SHADER, vertexPath, "VERTEX", vertexDeclarations);
+    if (tessControlPath && tessEvalPath)
+    {
+        stages[stageCount++] = compileStage(GL_TESS_CONTROL_SHADER, tessControlPath, "TESS_CONTROL");
+        stages[stageCount++] = compileStage(GL_TESS_EVALUATION_SHADER, tessEvalPath, "TESS_EVALUATION");
+    }
+    stages[stageCount++] = compileStage(GL_FRAGMENT_SHADER, fragmentPath, "FRAGMENT");
 
-    // 3. ɫ
+    // 2. 链接着色器程序
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    for (unsigned int i = 0; i < stageCount; ++i)
+        glAttachShader(ID, stages[i]);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
 
-    // 4. ɾм (ͲҪı)
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    // 3. 删除中间产物 (链接完就不需要独立的编译对象了)
+    for (unsigned int i = 0; i < stageCount; ++i)
+        glDeleteShader(stages[i]);
+}
+
+unsigned int Shader::compileStage(GLenum type, const char* path, const char* typeName, const std::string& declarations)
+{
+    // 从虚拟文件系统取源码
+    // 资源包已经 mmap 进来，这里拿到的是指向映射内存的视图，不经过 ifstream / stringstream / string 拷贝
+    AssetView source = VirtualFileSystem::Get().Open(path);
+    if (!source)
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+
+    // 【教学点 4】：源码不以 '\0' 结尾
+    // glShaderSource 支持显式传入长度，GL 按长度读取，不需要先转成 C 字符串
+    const char* code = source ? reinterpret_cast<const char*>(source.data) : "";
+    GLint length = static_cast<GLint>(source.size);
+
+    unsigned int shader = glCreateShader(type);
+    if (declarations.empty())
+    {
+        glShaderSource(shader, 1, &code, &length);
+    }
+    else
+    {
+        // 声明必须在 #version 之后；#extension 又必须出现在所有声明之前，所以跳过开头的这两类行
+        std::string_view text = source.Text();
+        size_t split = 0;
+        unsigned int headerLines = 0;
+        while (split < text.size())
+        {
+            std::string_view line = text.substr(split, text.find('\n', split) - split);
+            if (line.substr(0, 8) != "#version" && line.substr(0, 10) != "#extension")
+                break;
+            split = std::min(split + line.size() + 1, text.size());
+            ++headerLines;
+        }
+
+        // 插入之后用 #line 把行号拨回原文件，编译错误里的行号仍然对得上
+        std::string inserted = declarations + "#line " + std::to_string(headerLines + 1) + "\n";
+        const char* parts[3] = { code, inserted.c_str(), code + split };
+        GLint lengths[3] = { static_cast<GLint>(split), static_cast<GLint>(inserted.size()), static_cast<GLint>(source.size - split) };
+        glShaderSource(shader, 3, parts, lengths);
+    }
+    glCompileShader(shader);
+    checkCompileErrors(shader, typeName); // 使用封装好的检查函数
+    return shader;
 }
 
 void Shader::use()
@@ -81,11 +99,22 @@ void Shader::use()
 
 Shader::~Shader()
 {
-    // ɾɫͷ GPU ڴ
+    // 删除着色器程序，释放 GPU 内存
     glDeleteProgram(ID);
 }
 
-// ʵ
+int Shader::getUniformLocation(const std::string& name) const
+{
+    auto it = uniformLocations.find(name);
+    if (it != uniformLocations.end())
+        return it->second;
+
+    int location = glGetUniformLocation(ID, name.c_str());
+    uniformLocations.emplace(name, location);
+    return location;
+}
+
+// 辅助函数实现
 void Shader::checkCompileErrors(unsigned int shader, std::string type)
 {
     int success;
@@ -126,12 +155,12 @@ void Shader::setVec4(const std::string& name, const glm::vec4& value) const
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-    // location, count, transpose(Ƿת), value(ָ)
+    // location, count, transpose(是否转置), value(数据指针)
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 
-// Uniform úĿʵ (Ϊͨ)
+// Uniform 设置函数的空实现 (为了通过编译)
 void Shader::setBool(const std::string& name, bool value) const {
     glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
 }
@@ -0,0 +1,187 @@
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+VirtualFileSystem& VirtualFileSystem::Get()
+{
+    static VirtualFileSystem instance;
+    return instance;
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+    Unmount();
+}
+
+bool VirtualFileSystem::Mount(const char* archivePath)
+{
+    Unmount();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(archivePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view)
+    {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<const unsigned char*>(view);
+    mappedSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(archivePath, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后 fd 就可以关掉了，整个进程生命周期只有这一次 open
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    base = static_cast<const unsigned char*>(view);
+    mappedSize = static_cast<size_t>(st.st_size);
+#endif
+
+    // 校验文件头和索引范围，坏包直接放弃 (退回松散文件)
+    header = reinterpret_cast<const AssetArchive::Header*>(base);
+    bool valid = mappedSize >= sizeof(AssetArchive::Header)
+        && header->magic == AssetArchive::MAGIC
+        && header->version == AssetArchive::VERSION
+        && header->fileSize == mappedSize
+        && header->indexOffset + static_cast<uint64_t>(header->entryCount) * sizeof(AssetArchive::Entry) <= header->stringsOffset
+        && header->stringsOffset <= header->dataOffset
+        && header->dataOffset <= mappedSize;
+    if (!valid)
+    {
+        std::cout << "ERROR::VFS::INVALID_ARCHIVE: " << archivePath << std::endl;
+        Unmount();
+        return false;
+    }
+
+    entries = reinterpret_cast<const AssetArchive::Entry*>(base + header->indexOffset);
+    verified.assign(header->entryCount, 0);
+    stats.archiveBytes = mappedSize;
+    stats.archiveEntries = header->entryCount;
+    return true;
+}
+
+void VirtualFileSystem::Unmount()
+{
+    if (base)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(base), mappedSize);
+#endif
+    }
+    base = nullptr;
+    mappedSize = 0;
+    header = nullptr;
+    entries = nullptr;
+    verified.clear();
+    looseFiles.clear();
+    stats = Stats();
+}
+
+const AssetArchive::Entry* VirtualFileSystem::findEntry(const std::string& path) const
+{
+    uint64_t hash = AssetArchive::Hash(path.data(), path.size());
+    const AssetArchive::Entry* end = entries + header->entryCount;
+    const AssetArchive::Entry* it = std::lower_bound(entries, end, hash,
+        [](const AssetArchive::Entry& e, uint64_t h) { return e.pathHash < h; });
+    if (it == end || it->pathHash != hash)
+        return nullptr;
+
+    // 哈希命中后再比一次路径，防止不在包里的路径恰好撞上
+    const char* stored = reinterpret_cast<const char*>(base + header->stringsOffset + it->pathOffset);
+    if (it->pathLength != path.size() || path.compare(0, path.size(), stored, it->pathLength) != 0)
+        return nullptr;
+    return it;
+}
+
+AssetView VirtualFileSystem::Open(const std::string& path)
+{
+    if (!base)
+        return readLoose(path);
+
+    const AssetArchive::Entry* entry = findEntry(path);
+    if (!entry || entry->offset + entry->size > mappedSize)
+        return readLoose(path);
+
+    AssetView view;
+    view.data = base + entry->offset;
+    view.size = static_cast<size_t>(entry->size);
+
+    // 首次访问才校验内容哈希 (这一步也顺带把页读进来)
+    uint8_t& state = verified[entry - entries];
+    if (state == 0)
+    {
+        state = AssetArchive::Hash(view.data, view.size) == entry->contentHash ? 1 : 2;
+        if (state == 2)
+        {
+            stats.hashFailures++;
+            std::cout << "ERROR::VFS::HASH_MISMATCH: " << path << std::endl;
+        }
+    }
+    if (state == 2)
+        return AssetView();
+
+    stats.archiveHits++;
+    return view;
+}
+
+AssetView VirtualFileSystem::readLoose(const std::string& path)
+{
+    auto it = looseFiles.find(path);
+    if (it == looseFiles.end())
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return AssetView();
+
+        std::vector<unsigned char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+            return AssetView();
+
+        stats.looseReads++;
+        it = looseFiles.emplace(path, std::move(data)).first;
+    }
+
+    AssetView view;
+    view.data = it->second.data();
+    view.size = it->second.size();
+    // 空文件也要返回非空指针，否则调用方会当成"不存在"
+    static const unsigned char empty = 0;
+    if (view.size == 0)
+        view.data = &empty;
+    return view;
+}
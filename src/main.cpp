@@ -1,6 +1,10 @@
 ﻿#include <iostream>
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <cstdio>
+#include <functional>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -15,6 +19,59 @@
 #include "Shader.h"
 #include "Camera.h"
 #include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "LightGrid.h"
+#include "RainLayers.h"
+#include "MultiView.h"
+#include "FramePacer.h"
+#include "GpuResources.h"
+#include "GroundStreamer.h"
+#include "VirtualFileSystem.h"
+#include "Benchmark.h"
+
+// 一帧渲染需要的全部资源 (由 main 持有)
+struct SceneResources
+{
+	// 近景粒子特效 (--weather)：雨和雪二选一，没选中的那套指针为空
+	Shader* particleShader = nullptr;
+	Shader* groundShader = nullptr;
+	ParticleSystem<RainEffect>* particleSystem = nullptr;
+	Shader* snowShader = nullptr;
+	ParticleSystem<SnowEffect>* snowSystem = nullptr;
+	unsigned int particleTexture = 0;
+	GroundStreamer* groundStreamer = nullptr; // 相机周围的地块 (patch 网格)
+	unsigned int groundTextures[5] = {}; // albedo, normal, roughness, ao, disp
+	RenderQueue* renderQueue = nullptr;
+	LightGrid* lightGrid = nullptr;
+	std::vector<PointLight> lights;
+	Shader* rainFarShader = nullptr;
+	RainLayers* rainLayers = nullptr;   // 只在下雨时存在
+	MultiView* multiView = nullptr;   // 本帧的所有视图 (由调用方在 renderScene 之前设置)
+
+	// 初始化时查好的 uniform location，每帧只按 location 提交
+	// 相机矩阵不再是 uniform，统一在 MultiView 的 UBO 里；-1 (未查到) 时 glUniform* 什么也不做
+	struct { GLint time = -1, model = -1, wetness = -1, viewCount = -1, displacementScale = -1; } groundLoc;
+	struct { GLint nearRadius = -1, fadeWidth = -1, viewCount = -1; } particleLoc;
+	struct { GLint radius = -1, fadeWidth = -1, viewCount = -1; } snowLoc;
+	struct { GLint time = -1, nearRadius = -1, fadeWidth = -1, layerSpacing = -1, sheetHeight = -1, layerCount = -1, viewCount = -1; } rainFarLoc;
+};
+
+// 退出守卫：在 main 里声明于所有 GL 对象之前，局部变量逆序析构时它最后执行。
+// 这时句柄都已删除、上下文仍然有效：先报告泄漏，再关闭 GLFW (无头上下文由 HeadlessContext 自己销毁)
+struct ShutdownGuard
+{
+	bool glfwInitialized = false;
+
+	~ShutdownGuard()
+	{
+		GpuRegistry::Get().ReportLeaks();
+		if (glfwInitialized)
+			glfwTerminate();
+	}
+};
+
+// 材质 ID (参与排序键)
+enum MaterialId { MATERIAL_GROUND = 1, MATERIAL_RAIN = 2, MATERIAL_RAIN_FAR = 3, MATERIAL_SNOW = 4 };
 
 // 函数声明
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -23,6 +80,12 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 unsigned int generateProceduralTexture();
 unsigned int loadTexture(const char* path);
+void updateParticles(const SceneResources& scene, float dt, glm::vec2 cameraPos);
+void renderScene(const SceneResources& scene, float time, RenderStats& stats, GpuPassTimer* timer, const std::function<void()>& latch);
+int runBenchmark(const AppConfig& config, SceneResources& scene, FramePacer& pacer);
+void printPacing(const FramePacer::Stats& pacing);
+void printGpuMemory(const GpuRegistry& registry);
+void printGroundTiles(const GroundStreamer::Stats& tiles);
 //// STB_IMAGE_IMPLEMENTATION 宏会让库将实现代码编译进这个 cpp 文件
 //// 通常在大型项目中，会专门建立一个 src/stb_impl.cpp 来放这个宏，以加快编译速度
 //// 这里为了单文件连贯性，暂且放在 main.cpp 顶部
@@ -33,6 +96,16 @@ unsigned int loadTexture(const char* path);
 const unsigned int SCR_WIDTH = 1920;
 const unsigned int SCR_HEIGHT = 1080;
 
+// 投影近/远平面 (光照分簇的 Z 切片也依赖它们)
+const float Z_NEAR = 0.1f;
+const float Z_FAR = 100.0f;
+
+// dispMap 位移的最大高度 (米)，鹅卵石的起伏
+const float GROUND_DISPLACEMENT = 0.08f;
+
+// 多视图时相邻视图的水平间距 (米)：取人眼瞳距，两个视图即一副立体双目
+const float VIEW_SEPARATION = 0.065f;
+
 // 相机实例
 Camera camera(glm::vec3(0.0f, 1.6f, 2.7f));
 
@@ -47,37 +120,59 @@ float lastFrame = 0.0f;
 
 
 
-int main()
+int main(int argc, char** argv)
 {
+	// 命令行：--bench 时无头离屏基准测试，不弹窗口；--views / --fps / --gpu-budget 两种模式都生效
+	AppConfig config = AppConfig::FromArgs(argc, argv);
+
 	// ------------------------------
 	// 1. 初始化 GLFW
 	// ------------------------------
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "KineticCore - Refactored Shader", NULL, NULL);
-	if (window == NULL)
+	GLFWwindow* window = NULL;
+	std::unique_ptr<HeadlessContext> headless;
+	ShutdownGuard shutdown;
+	if (config.bench)
 	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return -1;
+		headless = HeadlessContext::Create(config);
+		if (!headless)
+		{
+			std::cout << "Failed to create headless GL context" << std::endl;
+			return -1;
+		}
 	}
-	glfwMakeContextCurrent(window);
-	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	else
+	{
+		glfwInit();
+		shutdown.glfwInitialized = true;
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+		window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "KineticCore - Refactored Shader", NULL, NULL);
+		if (window == NULL)
+		{
+			std::cout << "Failed to create GLFW window" << std::endl;
+			return -1;
+		}
+		glfwMakeContextCurrent(window);
+		glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-	// 绑定鼠标回调
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetScrollCallback(window, scroll_callback);
+		// 绑定鼠标回调
+		glfwSetCursorPosCallback(window, mouse_callback);
+		glfwSetScrollCallback(window, scroll_callback);
 
-	// 捕获鼠标，且隐藏光标
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		// 捕获鼠标，且隐藏光标
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+		// 交换间隔：指定了目标帧率就关掉垂直同步，由 FramePacer 控制节奏；否则跟随显示器刷新
+		glfwSwapInterval(config.targetFps > 0.0f ? 0 : 1);
+	}
 
 	// ------------------------------
 	// 2. 初始化 GLAD
 	// ------------------------------
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	GLADloadproc loader = headless ? headless->Loader() : (GLADloadproc)glfwGetProcAddress;
+	if (!gladLoadGLLoader(loader))
 	{
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
@@ -95,20 +190,50 @@ int main()
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	// 地面用四边形 patch 细分
+	glPatchParameteri(GL_PATCH_VERTICES, 4);
+
 
 	// ------------------------------
 	// 4. 初始化资源 (使用智能指针)
 	// ------------------------------
 
-    // 使用 std::unique_ptr 管理 Shader
-	auto shader = std::make_unique<Shader>("assets/shaders/particle.vert", "assets/shaders/particle.frag");
+	// 所有资源都从打包好的 assets.pak 里取 (一次 open + mmap)，没有包时退回读松散文件
+	if (!VirtualFileSystem::Get().Mount("assets.pak"))
+		std::cout << "assets.pak not found, reading loose files from assets/" << std::endl;
+
+	// 显存预算 (--gpu-budget MB)：超出时地面纹理逐级丢 mip
+	GpuRegistry::Get().SetBudget(static_cast<size_t>(config.gpuBudgetMB) * 1024 * 1024);
+
+	// 使用 std::unique_ptr 管理 Shader 和 ParticleSystem
+	// 粒子 shader 的实例属性 / SSBO 声明由特效的列类型列表生成，和 CPU 端的列布局一一对应
+	std::unique_ptr<Shader> shader, rainFarShader, snowShader;
+	std::unique_ptr<RainLayers> rainLayers;
+	std::unique_ptr<ParticleSystem<RainEffect>> particleSystem;
+	std::unique_ptr<ParticleSystem<SnowEffect>> snowSystem;
+	if (config.weather == AppConfig::Weather::Snow)
+	{
+		// 雪落得慢、视野里停留久，和雨同样 1 万片；没有远景层
+		snowShader = std::make_unique<Shader>("assets/shaders/snow.vert", "assets/shaders/snow.frag",
+			ParticleSystem<SnowEffect>::GetShaderDeclarations());
+		snowSystem = std::make_unique<ParticleSystem<SnowEffect>>(10000, SnowEffect::Params());
+	}
+	else
+	{
+		shader = std::make_unique<Shader>("assets/shaders/particle.vert", "assets/shaders/particle.frag",
+			ParticleSystem<RainEffect>::GetShaderDeclarations());
+
+		// 远景雨幕 + 近景粒子：粒子只在 nearRadius 以内模拟，更远处交给 RainLayers
+		// 近景圆盘面积比原先 50x50 的方块小得多，1 万个粒子的密度已经是原来的两倍多
+		particleSystem = std::make_unique<ParticleSystem<RainEffect>>(10000, RainEffect::Params());
 
-	// 使用 std::unique_ptr 管理 ParticleSystem
-	// 5000 个粒子作为起步
-	auto particleSystem = std::make_unique<ParticleSystem>(*shader, 25000);
+		// 第一层雨幕的半径和淡出带取自粒子系统自己的 Params，两边不会对不上
+		rainFarShader = std::make_unique<Shader>("assets/shaders/rain_far.vert", "assets/shaders/rain_far.frag");
+		rainLayers = std::make_unique<RainLayers>(particleSystem->GetParams(), RainLayers::Config());
+	}
 
 	// 生成纹理
-	unsigned int textureID = generateProceduralTexture();
+	GpuTexture particleTexture = GpuTexture::Adopt(generateProceduralTexture(), "rain particle");
 
 
 
@@ -118,42 +243,28 @@ int main()
 	// ---------------------------------------------------------
 
 	// 1. 地面 Shader (保持 unique_ptr 风格)
-	auto groundShader = std::make_unique<Shader>("assets/shaders/ground.vert", "assets/shaders/ground.frag");
-
-	// 2. 地面顶点数据 (移入 main 内部，拒绝全局污染)
-	float planeVertices[] = {
-		// positions            // normals         // texcoords
-		 25.0f, 0.0f,  25.0f,   0.0f, 1.0f, 0.0f,  25.0f,  0.0f,
-		-25.0f, 0.0f,  25.0f,   0.0f, 1.0f, 0.0f,   0.0f,  0.0f,
-		-25.0f, 0.0f, -25.0f,   0.0f, 1.0f, 0.0f,   0.0f, 25.0f,
-
-		 25.0f, 0.0f,  25.0f,   0.0f, 1.0f, 0.0f,  25.0f,  0.0f,
-		-25.0f, 0.0f, -25.0f,   0.0f, 1.0f, 0.0f,   0.0f, 25.0f,
-		 25.0f, 0.0f, -25.0f,   0.0f, 1.0f, 0.0f,  25.0f, 25.0f
-	};
+	// 细分路径：TCS 按屏幕边长 + 距离决定细分级别并剔除视锥外的 patch，TES 按 dispMap 位移
+	auto groundShader = std::make_unique<Shader>("assets/shaders/ground.vert", "assets/shaders/ground.tesc",
+		"assets/shaders/ground.tese", "assets/shaders/ground.frag");
 
-	// 3. 配置 OpenGL 对象
-	unsigned int planeVAO, planeVBO;
-	glGenVertexArrays(1, &planeVAO);
-	glGenBuffers(1, &planeVBO);
-	glBindVertexArray(planeVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-	glBindVertexArray(0);
+	// 帧节奏 (--fps N)：窗口和基准模式共用一个 FramePacer
+	// 地块池要知道 GPU 队列里最多有几帧，才不会覆盖在途帧还在读的槽
+	FramePacer::Config pacerConfig;
+	pacerConfig.targetFps = config.targetFps;
+	FramePacer pacer(pacerConfig);
+
+	// 2. 地面地块：跟着相机流式生成，patch 网格放在预分配的 GPU 槽池里 (LRU 回收)
+	//    启动时先同步铺好相机周围一圈，第一帧就有完整的地面
+	GroundStreamer groundStreamer(pacerConfig.maxFramesInFlight);
+	groundStreamer.Prefill(camera.Position);
 
 	// 4. 加载 PBR 纹理 (直接调用你已有的 loadTexture)
-	unsigned int groundDiff = loadTexture("assets/textures/cobblestone_ground_diff.jpg");
-	unsigned int groundNorm = loadTexture("assets/textures/cobblestone_ground_nor_gl.jpg");
-	unsigned int groundRough = loadTexture("assets/textures/cobblestone_ground_rough.jpg");
-	unsigned int groundAO = loadTexture("assets/textures/cobblestone_ground_ao.jpg");
-	unsigned int groundDisp = loadTexture("assets/textures/cobblestone_ground_disp.jpg");
+	//    大尺寸照片纹理，显存紧张时允许丢掉最高一级 mip
+	GpuTexture groundDiff = GpuTexture::Adopt(loadTexture("assets/textures/cobblestone_ground_diff.jpg"), "ground albedo", GpuResidency::MipDroppable);
+	GpuTexture groundNorm = GpuTexture::Adopt(loadTexture("assets/textures/cobblestone_ground_nor_gl.jpg"), "ground normal", GpuResidency::MipDroppable);
+	GpuTexture groundRough = GpuTexture::Adopt(loadTexture("assets/textures/cobblestone_ground_rough.jpg"), "ground roughness", GpuResidency::MipDroppable);
+	GpuTexture groundAO = GpuTexture::Adopt(loadTexture("assets/textures/cobblestone_ground_ao.jpg"), "ground ao", GpuResidency::MipDroppable);
+	GpuTexture groundDisp = GpuTexture::Adopt(loadTexture("assets/textures/cobblestone_ground_disp.jpg"), "ground displacement", GpuResidency::MipDroppable);
 
 	// 5. 预设 Shader 纹理单元
 	groundShader->use();
@@ -163,92 +274,400 @@ int main()
 	groundShader->setInt("aoMap", 3);
 	groundShader->setInt("dispMap", 4);
 
+	// 粒子纹理单元同样只需设置一次
+	if (shader)
+	{
+		shader->use();
+		shader->setInt("particleTexture", 0);
+		rainFarShader->use();
+		rainFarShader->setInt("streakTexture", 0);
+	}
+	if (snowShader)
+	{
+		snowShader->use();
+		snowShader->setInt("particleTexture", 0);
+	}
+
+	// 6. 渲染队列 + 状态缓存：冗余的 program / 纹理 / VAO / uniform 调用在这里被拦下
+	GLStateCache stateCache;
+	RenderQueue renderQueue(stateCache);
+
+	// 多视图 (--views N)：所有视图共用一次模拟、一次上传，每个 pass 一次绘制
+	MultiView multiView;
+	if (config.views > 1 && !MultiView::IsSupported())
+		std::cout << "GL_ARB_shader_viewport_layer_array not supported, rendering a single view" << std::endl;
+
+	// 7. 路灯：三排沿 Z 轴排开，(0, 5, -4) 那盏就是原来唯一的路灯
+	//    分簇包围球要包住地面上整个光斑：sqrt(光斑半径^2 + 灯高^2)
+	LightGrid lightGrid;
+	std::vector<PointLight> streetLights;
+	for (float x = -12.0f; x <= 12.0f; x += 12.0f)
+	{
+		for (float z = -28.0f; z <= 20.0f; z += 12.0f)
+		{
+			PointLight light;
+			light.position = glm::vec3(x, 5.0f, z);
+			light.color = glm::vec3(0.8f, 0.9f, 1.0f) * 4.5f;
+			light.range = 6.0f;
+			light.radius = glm::length(glm::vec2(light.range, light.position.y));
+			streetLights.push_back(light);
+		}
+	}
+
+	SceneResources scene;
+	scene.particleShader = shader.get();
+	scene.groundShader = groundShader.get();
+	scene.particleSystem = particleSystem.get();
+	scene.snowShader = snowShader.get();
+	scene.snowSystem = snowSystem.get();
+	scene.particleTexture = particleTexture.ID();
+	scene.groundStreamer = &groundStreamer;
+	scene.groundTextures[0] = groundDiff.ID();
+	scene.groundTextures[1] = groundNorm.ID();
+	scene.groundTextures[2] = groundRough.ID();
+	scene.groundTextures[3] = groundAO.ID();
+	scene.groundTextures[4] = groundDisp.ID();
+	scene.renderQueue = &renderQueue;
+	scene.lightGrid = &lightGrid;
+	scene.lights = streetLights;
+	scene.rainFarShader = rainFarShader.get();
+	scene.rainLayers = rainLayers.get();
+	scene.multiView = &multiView;
+	scene.groundLoc.time = groundShader->getUniformLocation("time");
+	scene.groundLoc.model = groundShader->getUniformLocation("model");
+	scene.groundLoc.wetness = groundShader->getUniformLocation("wetness");
+	scene.groundLoc.viewCount = groundShader->getUniformLocation("viewCount");
+	scene.groundLoc.displacementScale = groundShader->getUniformLocation("displacementScale");
+	if (shader)
+	{
+		scene.particleLoc.nearRadius = shader->getUniformLocation("nearRadius");
+		scene.particleLoc.fadeWidth = shader->getUniformLocation("fadeWidth");
+		scene.particleLoc.viewCount = shader->getUniformLocation("viewCount");
+		scene.rainFarLoc.time = rainFarShader->getUniformLocation("time");
+		scene.rainFarLoc.nearRadius = rainFarShader->getUniformLocation("nearRadius");
+		scene.rainFarLoc.fadeWidth = rainFarShader->getUniformLocation("fadeWidth");
+		scene.rainFarLoc.layerSpacing = rainFarShader->getUniformLocation("layerSpacing");
+		scene.rainFarLoc.sheetHeight = rainFarShader->getUniformLocation("sheetHeight");
+		scene.rainFarLoc.layerCount = rainFarShader->getUniformLocation("layerCount");
+		scene.rainFarLoc.viewCount = rainFarShader->getUniformLocation("viewCount");
+	}
+	if (snowShader)
+	{
+		scene.snowLoc.radius = snowShader->getUniformLocation("radius");
+		scene.snowLoc.fadeWidth = snowShader->getUniformLocation("fadeWidth");
+		scene.snowLoc.viewCount = snowShader->getUniformLocation("viewCount");
+	}
 
+	// 基准模式同样靠局部变量的逆序析构释放资源，最后由 ShutdownGuard 报告泄漏
+	if (config.bench)
+		return runBenchmark(config, scene, pacer);
 
 	// ------------------------------
 	// 5. 渲染循环
 	// ------------------------------
+	RenderStats stats;
+
+	// 按当前相机计算所有视图的矩阵
+	// 视口按当前帧缓冲尺寸 (像素) 划分：窗口缩放、HiDPI 下与窗口坐标不同；最小化时尺寸为 0，按 1 处理
+	auto setViews = [&]() {
+		int fbWidth = 0, fbHeight = 0;
+		glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+		multiView.SetViews(MultiView::SideBySide(config.views, camera.Position, camera.Front, camera.Up, camera.Right,
+			camera.Zoom, (float)std::max(fbWidth, 1), (float)std::max(fbHeight, 1), Z_NEAR, Z_FAR, VIEW_SEPARATION));
+	};
+
 	while (!glfwWindowShouldClose(window))
 	{
+		// 限制 GPU 队列深度 + 等到本帧的开始时刻
+		pacer.BeginFrame();
+
+		// 显存超出预算时给纹理降级
+		GpuRegistry::Get().Enforce();
+
 		// 计算 DeltaTime 
 		float currentFrame = static_cast<float>(glfwGetTime());
 		deltaTime = currentFrame - lastFrame;
 		lastFrame = currentFrame;
 
 		// 输入处理
+		glfwPollEvents();
 		processInput(window);
+		setViews();
 
 		// 清屏 (背景色设为深色，接近纯黑的虚空感)
 		glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// --- 1. 统一计算矩阵 (供所有 Shader 使用) ---
-		glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-		glm::mat4 view = camera.GetViewMatrix();
-		glm::mat4 model = glm::mat4(1.0f);
-
-		// --- 2. 渲染地面 (PBR Wetness) ---
-		groundShader->use();
-		groundShader->setFloat("time", static_cast<float>(glfwGetTime()));
-		groundShader->setMat4("projection", projection);
-		groundShader->setMat4("view", view);
-		groundShader->setMat4("model", model);
-
-		// 设置光照与湿润参数
-		groundShader->setVec3("viewPos", camera.Position);
-		groundShader->setVec3("lightPos", glm::vec3(0.0f, 10.0f, 0.0f));
-		groundShader->setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-		groundShader->setFloat("wetness", 0.45f); // <--- 设为 1.0 满湿润度，强制看效果
-
-		// 绑定纹理
-		glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, groundDiff);
-		glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, groundNorm);
-		glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, groundRough);
-		glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, groundAO);
-		glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, groundDisp);
-
-		glBindVertexArray(planeVAO);
-		glDrawArrays(GL_TRIANGLES, 0, 6);
-		glBindVertexArray(0);
-
-		// --- 3. 渲染粒子 (Transparent Object 放在最后) ---
-
-		// 激活着色器
-		shader->use();
-		shader->setInt("particleTexture", 0);
-		// 设置摄像机矩阵
-		shader->setMat4("projection", projection);
-		shader->setMat4("view", view);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-
 		// 传递 Camera XZ 坐标以实现跟随
-		// [重要] 分离更新与渲染
-		// ParticleSystem::Update 和 Draw 还是耦合在一起的 (都在 Update 里或者混着)
-		// 这一步我们先把调用方式改得像样一点，下一阶段再去拆解 ParticleSystem 类
-
-		// 这里的 offset 暂时没用，先传个 0
-		particleSystem->Update(deltaTime, glm::vec2(camera.Position.x, camera.Position.z));
-		particleSystem->Draw(camera.Position); // 这一步在你的类里虽然包含在Update里了，但为了语义清晰，以后要拆出来
-
-
-		// 交换缓冲 & 轮询事件
+		// [重要] 分离更新与渲染：先推进模拟，再统一提交两个 pass
+		updateParticles(scene, deltaTime, glm::vec2(camera.Position.x, camera.Position.z));
+		groundStreamer.Update(camera.Position, deltaTime);
+
+		// --- 晚锁存：模拟更新和组装 DrawPacket 期间到达的鼠标事件，在 Execute 的前一刻补上 ---
+		// renderScene 随后立刻把新矩阵写进持久映射的 UBO 并执行队列
+		renderScene(scene, currentFrame, stats, nullptr, [&]() {
+			glfwPollEvents();
+			pacer.MarkInput();
+			setViews();
+		});
+		pacer.EndFrame();
+
+		// 交换缓冲
 		glfwSwapBuffers(window);
-		glfwPollEvents();
 	}
+	printPacing(pacer.GetStats());
+	printGroundTiles(groundStreamer.GetStats());
 
 	// ------------------------------
 	// 6. 资源释放
 	// ------------------------------
 	// unique_ptr 会在这里自动释放 particleSystem 和 shader，无需 delete
-	// 只需处理 OpenGL 的资源
-	glDeleteTextures(1, &textureID);
-	glfwTerminate();
+	// GL 对象都由 GpuRegistry 的句柄持有，同样随作用域释放；之后 ShutdownGuard 报告泄漏并关闭 GLFW
+	return 0;
+}
+
+// 推进当前天气的粒子模拟 (只有一套非空)
+void updateParticles(const SceneResources& scene, float dt, glm::vec2 cameraPos)
+{
+	if (scene.particleSystem)
+		scene.particleSystem->Update(dt, cameraPos);
+	if (scene.snowSystem)
+		scene.snowSystem->Update(dt, cameraPos);
+}
+
+// 粒子特效共用的提交路径：GPU 列先上传 (不论多少个视图都只传一次)，返回一次实例化绘制的 DrawPacket
+template<typename Effect>
+DrawPacket prepareParticles(ParticleSystem<Effect>& system, unsigned int program, unsigned int texture, unsigned int viewCount)
+{
+	system.Upload();
+	system.SetViewCount(viewCount);
+
+	DrawPacket packet;
+	packet.program = program;
+	packet.vao = system.GetVAO();
+	packet.textures[0] = texture;
+	packet.textureCount = 1;
+	packet.count = 6;
+	packet.instanceCount = system.GetAmount() * viewCount;
+	return packet;
+}
+
+// 渲染一帧：地面 (PBR Wetness) + 粒子
+// 两个 pass 都只提交 DrawPacket，由 RenderQueue 排序后经状态缓存统一执行
+// 多视图时每个 DrawPacket 的实例数乘以视图数，顶点着色器用 gl_ViewportIndex 分发到各视图
+// timer 非空时 (基准模式) 为每个 pass 包一层 GPU 计时查询
+// latch 在所有 DrawPacket 组装完、写 UBO 和 Execute 之前调用：调用方在这里采样最新输入并更新视图 (晚锁存)
+void renderScene(const SceneResources& scene, float time, RenderStats& stats, GpuPassTimer* timer, const std::function<void()>& latch)
+{
+	RenderQueue& queue = *scene.renderQueue;
+	glm::mat4 model = glm::mat4(1.0f);
+	unsigned int viewCount = scene.multiView->GetViewCount();
+
+	// --- 1. 路灯分簇 (CPU)，每个视图一套簇，结果以 SSBO 交给地面 shader ---
+	//    分簇 (以及下面地块的深度键) 用的是帧开头的相机，不等晚锁存：分簇要先于组装绘制完成。
+	//    晚锁存只补几毫秒的鼠标转动，最多让簇边界附近的少数片元查到相邻簇的灯光列表；
+	//    灯光在 range 边缘已被 spotlightMask 压到 0，看不出差别
+	scene.lightGrid->Build(scene.lights, scene.multiView->GetViews(), Z_NEAR, Z_FAR);
+	scene.lightGrid->Upload();
+
+	// --- 2. 地面 (PBR Wetness)，每个已就绪的地块一个 DrawPacket ---
+	//    所有地块共用 VAO / program / 纹理，状态缓存只在第一块时真正切换状态
+	//    深度键取地块中心到相机的水平距离，同状态内由近到远画，远处地块被近处挡住的像素能被 early-z 拒掉
+	DrawPacket ground;
+	ground.program = scene.groundShader->ID;
+	ground.vao = scene.groundStreamer->GetVAO();
+	for (unsigned int i = 0; i < 5; ++i)
+		ground.textures[i] = scene.groundTextures[i];
+	ground.textureCount = 5;
+	ground.mode = GL_PATCHES;
+	ground.count = GroundStreamer::VERTICES_PER_TILE;
+	ground.instanceCount = viewCount;
+
+	glm::vec3 eye = scene.multiView->GetViews().front().position;
+	for (const GroundStreamer::DrawTile& tile : scene.groundStreamer->GetDrawTiles())
+	{
+		ground.first = static_cast<GLint>(tile.first);
+		float depth = glm::length(tile.center - glm::vec2(eye.x, eye.z)) / Z_FAR;
+		// 湿润参数 (光照来自分簇 SSBO)
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::PASS_OPAQUE, ground.program, MATERIAL_GROUND, depth), ground, {
+			UniformValue::Float(scene.groundLoc.time, time),
+			UniformValue::Mat4(scene.groundLoc.model, model),
+			UniformValue::Float(scene.groundLoc.wetness, 0.45f), // <--- 设为 1.0 满湿润度，强制看效果
+			UniformValue::Int(scene.groundLoc.viewCount, static_cast<int>(viewCount)),
+			UniformValue::Float(scene.groundLoc.displacementScale, GROUND_DISPLACEMENT),
+		});
+	}
+
+	// --- 3. 远景雨幕 (半透明，深度键最大，最先画；只在下雨时有) ---
+	if (scene.rainLayers)
+	{
+		const RainLayers::Config& rainConfig = scene.rainLayers->GetConfig();
+		const RainEffect::Params& nearParams = scene.rainLayers->GetNearParams();
+		DrawPacket rainFar;
+		rainFar.program = scene.rainFarShader->ID;
+		rainFar.vao = scene.rainLayers->GetVAO();
+		rainFar.textures[0] = scene.rainLayers->GetTexture();
+		rainFar.textureCount = 1;
+		rainFar.count = scene.rainLayers->GetVertexCount();
+		rainFar.instanceCount = rainConfig.layerCount * viewCount;
+
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::PASS_TRANSPARENT, rainFar.program, MATERIAL_RAIN_FAR, 1.0f), rainFar, {
+			UniformValue::Float(scene.rainFarLoc.time, time),
+			UniformValue::Float(scene.rainFarLoc.nearRadius, nearParams.nearRadius),
+			UniformValue::Float(scene.rainFarLoc.fadeWidth, nearParams.fadeWidth),
+			UniformValue::Float(scene.rainFarLoc.layerSpacing, rainConfig.layerSpacing),
+			UniformValue::Float(scene.rainFarLoc.sheetHeight, rainConfig.height),
+			UniformValue::Int(scene.rainFarLoc.layerCount, static_cast<int>(rainConfig.layerCount)),
+			UniformValue::Int(scene.rainFarLoc.viewCount, static_cast<int>(viewCount)),
+		});
+
+		// --- 4. 近景粒子 (Transparent Object 放在最后) ---
+		DrawPacket rain = prepareParticles(*scene.particleSystem, scene.particleShader->ID, scene.particleTexture, viewCount);
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::PASS_TRANSPARENT, rain.program, MATERIAL_RAIN, 0.0f), rain, {
+			UniformValue::Float(scene.particleLoc.nearRadius, nearParams.nearRadius),
+			UniformValue::Float(scene.particleLoc.fadeWidth, nearParams.fadeWidth),
+			UniformValue::Int(scene.particleLoc.viewCount, static_cast<int>(viewCount)),
+		});
+	}
+	if (scene.snowSystem)
+	{
+		const SnowEffect::Params& snowParams = scene.snowSystem->GetParams();
+		DrawPacket snow = prepareParticles(*scene.snowSystem, scene.snowShader->ID, scene.particleTexture, viewCount);
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::PASS_TRANSPARENT, snow.program, MATERIAL_SNOW, 0.0f), snow, {
+			UniformValue::Float(scene.snowLoc.radius, snowParams.radius),
+			UniformValue::Float(scene.snowLoc.fadeWidth, snowParams.fadeWidth),
+			UniformValue::Int(scene.snowLoc.viewCount, static_cast<int>(viewCount)),
+		});
+	}
+
+	// --- 5. 晚锁存，所有视图的矩阵 -> UBO，视口数组 (紧挨着执行) ---
+	latch();
+	scene.multiView->Upload();
+
+	// --- 6. 排序 + 执行 ---
+	bool timing = false;
+	stats = queue.Execute([&](RenderQueue::Pass pass) {
+		if (!timer) return;
+		if (timing) timer->End();
+		timer->Begin(pass);
+		timing = true;
+	});
+	if (timing) timer->End();
+}
+
+// 沿脚本化相机路径渲染 N 帧到 FBO，输出帧时间分布、调用计数和关键帧哈希
+// pacer 由 main 创建 (--fps N 时按目标帧率节奏出帧，报告里的延迟和抖动才有意义)
+int runBenchmark(const AppConfig& config, SceneResources& scene, FramePacer& pacer)
+{
+	OffscreenTarget target(config.width, config.height);
+	GpuPassTimer timer(RenderQueue::PASS_COUNT);
+	BenchReport report({ "opaque", "transparent", "simulate" });
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+	report.SetRenderer(renderer ? reinterpret_cast<const char*>(renderer) : "", RenderQueue::PASS_COUNT);
+	CameraPath path = CameraPath::Default();
+
+	// 关键帧：均匀分布，最后一个固定在末帧
+	std::vector<unsigned int> keyFrames;
+	for (unsigned int k = 1; k <= config.keyFrameCount; ++k)
+		keyFrames.push_back(static_cast<unsigned int>(static_cast<unsigned long long>(config.frames) * k / config.keyFrameCount) - 1);
+
+	RenderStats stats;
+	std::vector<float> passMs;
+	std::vector<unsigned char> pixels;
+	size_t nextKey = 0;
+
+	for (unsigned int frame = 0; frame < config.frames; ++frame)
+	{
+		pacer.BeginFrame();
+		GpuRegistry::Get().Enforce();
+		auto frameStart = std::chrono::steady_clock::now();
+
+		// 固定步长：模拟和 shader 时间都只依赖帧号，保证结果可复现
+		float t = config.frames > 1 ? static_cast<float>(frame) / (config.frames - 1) : 0.0f;
+		float time = frame * config.fixedDeltaTime;
+		path.Apply(camera, t);
+
+		target.Bind();
+		glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		scene.multiView->SetViews(MultiView::SideBySide(config.views, camera.Position, camera.Front, camera.Up, camera.Right,
+			camera.Zoom, (float)config.width, (float)config.height, Z_NEAR, Z_FAR, VIEW_SEPARATION));
+
+		auto simStart = std::chrono::steady_clock::now();
+		updateParticles(scene, config.fixedDeltaTime, glm::vec2(camera.Position.x, camera.Position.z));
+		scene.groundStreamer->Update(camera.Position, config.fixedDeltaTime);
+		float simMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - simStart).count();
+
+		// 脚本化相机没有新输入要补，晚锁存点只记录时间
+		renderScene(scene, time, stats, &timer, [&]() { pacer.MarkInput(); });
+		pacer.EndFrame();
+
+		// 每帧同步一次，帧时间才是真实的 CPU + GPU 耗时
+		glFinish();
+		float frameMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+
+		timer.Collect(passMs);
+		passMs.push_back(simMs);
+		if (frame >= config.warmupFrames)
+			report.AddFrame(frameMs, passMs, stats);
+
+		if (nextKey < keyFrames.size() && frame == keyFrames[nextKey])
+		{
+			target.ReadPixels(pixels);
+			report.AddKeyFrame(frame, PerceptualHash(pixels, config.width, config.height));
+			++nextKey;
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (scene.particleSystem)
+		report.AddArenaStats("rain", scene.particleSystem->GetArenaStats());
+	if (scene.snowSystem)
+		report.AddArenaStats("snow", scene.snowSystem->GetArenaStats());
+	report.Print();
+	std::cout << "  views " << scene.multiView->GetViewCount() << " (single pass)" << std::endl;
+	const VirtualFileSystem::Stats& vfs = VirtualFileSystem::Get().GetStats();
+	std::cout << "  vfs archive " << vfs.archiveEntries << " entries " << vfs.archiveBytes << " B  hits " << vfs.archiveHits
+		<< "  loose reads " << vfs.looseReads << "  hash failures " << vfs.hashFailures << std::endl;
+	std::cout << "  lights " << scene.lights.size()
+		<< "  active clusters " << scene.lightGrid->GetActiveClusters() << "/" << LightGrid::CLUSTER_COUNT * scene.multiView->GetViewCount()
+		<< "  light-cluster pairs " << scene.lightGrid->GetLightClusterPairs() << " (last frame)" << std::endl;
+	printPacing(pacer.GetStats());
+	printGpuMemory(GpuRegistry::Get());
+	printGroundTiles(scene.groundStreamer->GetStats());
 	return 0;
 }
 
+// 显存登记表：当前总量、峰值、预算，以及预算压力下做过的降级 / 释放
+void printGpuMemory(const GpuRegistry& registry)
+{
+	const GpuRegistry::Totals& totals = registry.GetTotals();
+	std::printf("  gpu memory buffers %.2f MB (%u)  images %.2f MB (%u textures, %u renderbuffers)  vertex arrays %u  peak %.2f MB\n",
+		totals.bufferBytes / 1048576.0, totals.buffers, totals.textureBytes / 1048576.0, totals.textures,
+		totals.renderbuffers, totals.vertexArrays, totals.peakBytes / 1048576.0);
+	std::printf("  gpu budget %.2f MB  mip drops %u\n", registry.GetBudget() / 1048576.0, totals.mipDrops);
+}
+
+// 地块流式加载：池的占用、可见地块的命中率，以及请求 / 上传 / 淘汰次数
+void printGroundTiles(const GroundStreamer::Stats& tiles)
+{
+	std::printf("  ground tiles resident %u/%u  hit rate %.1f%% (%llu/%llu)  requests %llu  uploads %llu  evictions %llu  discarded %llu\n",
+		tiles.resident, GroundStreamer::SLOT_COUNT, tiles.HitRate() * 100.0f,
+		static_cast<unsigned long long>(tiles.hits), static_cast<unsigned long long>(tiles.lookups),
+		static_cast<unsigned long long>(tiles.requests), static_cast<unsigned long long>(tiles.uploads),
+		static_cast<unsigned long long>(tiles.evictions), static_cast<unsigned long long>(tiles.discarded));
+}
+
+// 帧节奏统计：输入采样 -> 提交完成的延迟，帧间隔及其抖动
+void printPacing(const FramePacer::Stats& pacing)
+{
+	std::printf("  pacing %u frames  input->submit mean %.3f  p99 %.3f  max %.3f ms\n",
+		pacing.frames, pacing.latencyMeanMs, pacing.latencyP99Ms, pacing.latencyMaxMs);
+	std::printf("  pacing interval mean %.3f  p99 %.3f  jitter %.3f ms  fence waits %u (%.3f ms)\n",
+		pacing.intervalMeanMs, pacing.intervalP99Ms, pacing.jitterMs, pacing.fenceWaits, pacing.fenceWaitMs);
+}
+
 //// 纹理加载函数
 //unsigned int loadTexture(const char* path)
 //{
@@ -337,6 +756,7 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 	camera.ProcessMouseScroll(static_cast<float>(yoffset));
 }
 
+// 各视图的视口由渲染循环每帧按帧缓冲尺寸重新计算，这里的 glViewport 只管到下一帧为止
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	glViewport(0, 0, width, height);
@@ -397,8 +817,13 @@ unsigned int loadTexture(char const* path)
 	unsigned int textureID;
 	glGenTextures(1, &textureID);
 
-	int width, height, nrComponents;
-	unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
+	// 压缩数据 (jpg/png) 直接从映射内存解码，不再经过 stdio 读一遍
+	AssetView file = VirtualFileSystem::Get().Open(path);
+
+	int width = 0, height = 0, nrComponents = 0;
+	unsigned char* data = NULL;
+	if (file)
+		data = stbi_load_from_memory(file.data, static_cast<int>(file.size), &width, &height, &nrComponents, 0);
 	if (data)
 	{
 		GLenum format;
@@ -425,17 +850,4 @@ unsigned int loadTexture(char const* path)
 	}
 
 	return textureID;
-}
-
-// 地面顶点数据 (Pos, Normal, TexCoords)
-// 放在 y = -2.0 的位置，这也是雨滴重置的高度
-float planeVertices[] = {
-	// positions            // normals         // texcoords
-	 25.0f, -2.0f,  25.0f,  0.0f, 1.0f, 0.0f,  25.0f,  0.0f,
-	-25.0f, -2.0f,  25.0f,  0.0f, 1.0f, 0.0f,   0.0f,  0.0f,
-	-25.0f, -2.0f, -25.0f,  0.0f, 1.0f, 0.0f,   0.0f, 25.0f,
-
-	 25.0f, -2.0f,  25.0f,  0.0f, 1.0f, 0.0f,  25.0f,  0.0f,
-	-25.0f, -2.0f, -25.0f,  0.0f, 1.0f, 0.0f,   0.0f, 25.0f,
-	 25.0f, -2.0f, -25.0f,  0.0f, 1.0f, 0.0f,  25.0f, 25.0f
-};
\ No newline at end of file
+}
\ No newline at end of file
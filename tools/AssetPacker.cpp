@@ -0,0 +1,136 @@
+// 资源打包工具：把 assets/ 目录打成一个 assets.pak (格式见 include/AssetArchive.h)
+// 用法: AssetPacker <资源目录> <输出文件>
+// 由 CMake 在构建时调用，运行时只需要打开这一个文件。
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PackedFile
+{
+    std::string path;            // 包内路径，如 "assets/shaders/ground.frag"
+    std::vector<char> data;
+    AssetArchive::Entry entry;
+};
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: AssetPacker <assets dir> <output.pak>" << std::endl;
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    std::string prefix = root.filename().generic_string();   // 包内路径保持与松散文件一致
+
+    // 1. 收集文件
+    std::vector<PackedFile> files;
+    for (const fs::directory_entry& item : fs::recursive_directory_iterator(root))
+    {
+        if (!item.is_regular_file())
+            continue;
+
+        PackedFile file;
+        file.path = prefix + "/" + fs::relative(item.path(), root).generic_string();
+
+        std::ifstream in(item.path(), std::ios::binary);
+        file.data.resize(static_cast<size_t>(item.file_size()));
+        if (!in.read(file.data.data(), static_cast<std::streamsize>(file.data.size())))
+        {
+            std::cerr << "AssetPacker: failed to read " << item.path() << std::endl;
+            return 1;
+        }
+
+        std::memset(&file.entry, 0, sizeof(file.entry));
+        file.entry.pathHash = AssetArchive::Hash(file.path.data(), file.path.size());
+        file.entry.contentHash = AssetArchive::Hash(file.data.data(), file.data.size());
+        file.entry.size = file.data.size();
+        files.push_back(std::move(file));
+    }
+
+    // 2. 按路径哈希排序，运行时二分查找；哈希冲突直接报错，不做链表
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+        return a.entry.pathHash < b.entry.pathHash;
+    });
+    for (size_t i = 1; i < files.size(); ++i)
+    {
+        if (files[i].entry.pathHash == files[i - 1].entry.pathHash)
+        {
+            std::cerr << "AssetPacker: path hash collision: " << files[i - 1].path << " / " << files[i].path << std::endl;
+            return 1;
+        }
+    }
+
+    // 3. 计算布局
+    AssetArchive::Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = AssetArchive::MAGIC;
+    header.version = AssetArchive::VERSION;
+    header.entryCount = static_cast<uint32_t>(files.size());
+    header.dataAlignment = AssetArchive::DATA_ALIGNMENT;
+    header.indexOffset = sizeof(AssetArchive::Header);
+    header.stringsOffset = header.indexOffset + files.size() * sizeof(AssetArchive::Entry);
+
+    std::string strings;
+    for (PackedFile& file : files)
+    {
+        file.entry.pathOffset = static_cast<uint32_t>(strings.size());
+        file.entry.pathLength = static_cast<uint32_t>(file.path.size());
+        strings += file.path;
+        strings += '\0';
+    }
+
+    uint64_t offset = alignUp(header.stringsOffset + strings.size(), AssetArchive::DATA_ALIGNMENT);
+    header.dataOffset = offset;
+    for (PackedFile& file : files)
+    {
+        file.entry.offset = offset;
+        offset = alignUp(offset + file.entry.size, AssetArchive::DATA_ALIGNMENT);
+    }
+    header.fileSize = offset;
+
+    // 4. 写出 (先写临时文件再改名，构建中断不会留下半个包)
+    fs::path output = argv[2];
+    fs::path temp = output;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const PackedFile& file : files)
+            out.write(reinterpret_cast<const char*>(&file.entry), sizeof(file.entry));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        static const char zeros[AssetArchive::DATA_ALIGNMENT] = {};
+        for (const PackedFile& file : files)
+        {
+            uint64_t pad = file.entry.offset - static_cast<uint64_t>(out.tellp());
+            out.write(zeros, static_cast<std::streamsize>(pad));
+            out.write(file.data.data(), static_cast<std::streamsize>(file.data.size()));
+        }
+        uint64_t pad = header.fileSize - static_cast<uint64_t>(out.tellp());
+        out.write(zeros, static_cast<std::streamsize>(pad));
+
+        if (!out)
+        {
+            std::cerr << "AssetPacker: failed to write " << temp << std::endl;
+            return 1;
+        }
+    }
+    fs::rename(temp, output);
+
+    std::cout << "AssetPacker: " << files.size() << " files, " << header.fileSize << " bytes -> " << output.generic_string() << std::endl;
+    return 0;
+}